@@ -0,0 +1,229 @@
+// Engine-free replacements for Private/StarflightBridge.cpp and
+// Private/StarflightAssets.cpp, linked into starflight_core.
+
+#include "HeadlessCore.h"
+#include "StarflightBridge.h"
+#include "StarflightAssets.h"
+#include "graphics.h"
+
+#include "lodepng.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <atomic>
+#include <mutex>
+
+// Global variable to hold project directory for emulator file loading
+std::string g_ProjectDirectory;
+
+DEFINE_LOG_CATEGORY_STATIC(LogStarflightAssets, Log, All);
+
+namespace
+{
+	std::mutex gSinksMutex;
+	FrameSinkFn gFrameSink;
+	AudioSinkFn gAudioSink;
+	RotoscopeSinkFn gRotoSink;
+	SpaceManMoveSinkFn gSpaceManSink;
+	StatusSinkFn gStatusSink;
+	FStarflightStatus gLastStatus{ FStarflightEmulatorState::Off, 0u, 0u };
+	std::atomic<ELogVerbosity> gLogVerbosity{ ELogVerbosity::Warning };
+}
+
+// ------------------------------------------------
+// Logging
+// ------------------------------------------------
+
+static const char* VerbosityName(ELogVerbosity verbosity)
+{
+	switch (verbosity)
+	{
+	case ELogVerbosity::Fatal:   return "Fatal";
+	case ELogVerbosity::Error:   return "Error";
+	case ELogVerbosity::Warning: return "Warning";
+	case ELogVerbosity::Display: return "Display";
+	case ELogVerbosity::Log:     return "Log";
+	default:                     return "Verbose";
+	}
+}
+
+void HeadlessSetLogVerbosity(ELogVerbosity verbosity)
+{
+	gLogVerbosity.store(verbosity, std::memory_order_relaxed);
+}
+
+void HeadlessLog(const char* category, ELogVerbosity verbosity, const char* format, ...)
+{
+	if (verbosity != ELogVerbosity::Fatal && verbosity > gLogVerbosity.load(std::memory_order_relaxed))
+		return;
+
+	fprintf(stderr, "%s: %s: ", category, VerbosityName(verbosity));
+	va_list args;
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+	fputc('\n', stderr);
+
+	if (verbosity == ELogVerbosity::Fatal)
+	{
+		fflush(stderr);
+		abort();
+	}
+}
+
+// ------------------------------------------------
+// Sinks
+// ------------------------------------------------
+
+void SetFrameSink(FrameSinkFn cb)
+{
+	std::lock_guard<std::mutex> lock(gSinksMutex);
+	gFrameSink = std::move(cb);
+}
+
+void RequestFullFrame()
+{
+	GraphicsRequestFullFrame();
+}
+
+uint64_t GetFramePublishTime()
+{
+	return GraphicsEmittedPublishTime();
+}
+
+void SetAudioSink(AudioSinkFn cb)
+{
+	std::lock_guard<std::mutex> lock(gSinksMutex);
+	gAudioSink = std::move(cb);
+}
+
+void SetRotoscopeSink(RotoscopeSinkFn cb)
+{
+	std::lock_guard<std::mutex> lock(gSinksMutex);
+	gRotoSink = std::move(cb);
+}
+
+void SetSpaceManMoveSink(SpaceManMoveSinkFn cb)
+{
+	std::lock_guard<std::mutex> lock(gSinksMutex);
+	gSpaceManSink = std::move(cb);
+}
+
+void SetStatusSink(StatusSinkFn cb)
+{
+	StatusSinkFn sink;
+	FStarflightStatus statusSnapshot;
+	{
+		std::lock_guard<std::mutex> lock(gSinksMutex);
+		gStatusSink = std::move(cb);
+		sink = gStatusSink;
+		statusSnapshot = gLastStatus;
+	}
+	if (sink) { sink(statusSnapshot); }
+}
+
+void EmitFrame(const uint8_t* bgra, int w, int h, int pitch, const FStarflightDirtyRect* dirty, int dirtyCount)
+{
+	FrameSinkFn sink;
+	{
+		std::lock_guard<std::mutex> lock(gSinksMutex);
+		sink = gFrameSink;
+	}
+	if (sink) { sink(bgra, w, h, pitch, dirty, dirtyCount); }
+}
+
+void EmitRotoscope(const uint8_t* bgra, int w, int h, int pitch)
+{
+	RotoscopeSinkFn sink;
+	{
+		std::lock_guard<std::mutex> lock(gSinksMutex);
+		sink = gRotoSink;
+	}
+	if (sink) { sink(bgra, w, h, pitch); }
+}
+
+void EmitSpaceManMove(uint16_t pixelX, uint16_t pixelY)
+{
+	SpaceManMoveSinkFn sink;
+	{
+		std::lock_guard<std::mutex> lock(gSinksMutex);
+		sink = gSpaceManSink;
+	}
+	if (sink) { sink(pixelX, pixelY); }
+}
+
+void EmitStatus(const FStarflightStatus& status)
+{
+	StatusSinkFn sink;
+	{
+		std::lock_guard<std::mutex> lock(gSinksMutex);
+		sink = gStatusSink;
+		gLastStatus = status;
+	}
+	if (sink) { sink(status); }
+}
+
+// ------------------------------------------------
+// Assets
+//
+// The PNGs are read from <project>/Plugins/StarflightRuntime/Content, or from
+// the directory given by STARFLIGHT_CONTENT_DIR.
+// ------------------------------------------------
+
+FStarflightAssets& FStarflightAssets::Get()
+{
+	static FStarflightAssets Instance;
+	return Instance;
+}
+
+void FStarflightAssets::Initialize()
+{
+	const char* env = getenv("STARFLIGHT_CONTENT_DIR");
+	FString ContentDir = env ? FString(env) + "/" : g_ProjectDirectory + "Plugins/StarflightRuntime/Content/";
+
+	if (!LoadPNGFile(ContentDir + "mini_earth.png", MiniEarthData, MiniEarthWidth, MiniEarthHeight))
+	{
+		UE_LOG(LogStarflightAssets, Error, TEXT("Failed to load mini_earth.png from: %s"), (ContentDir + "mini_earth.png").c_str());
+	}
+	if (!LoadPNGFile(ContentDir + "lofi_earth.png", LofiEarthData, LofiEarthWidth, LofiEarthHeight))
+	{
+		UE_LOG(LogStarflightAssets, Error, TEXT("Failed to load lofi_earth.png from: %s"), (ContentDir + "lofi_earth.png").c_str());
+	}
+}
+
+bool FStarflightAssets::LoadPNGFile(const FString& FilePath, TArray<uint8>& OutData, int32& OutWidth, int32& OutHeight)
+{
+	std::vector<unsigned char> ImageData;
+	unsigned Width, Height;
+	unsigned Error = lodepng::decode(ImageData, Width, Height, FilePath, LCT_GREY, 8);
+	if (Error)
+	{
+		return false;
+	}
+
+	OutWidth = Width;
+	OutHeight = Height;
+	OutData.assign(ImageData.begin(), ImageData.end());
+	return true;
+}
+
+void FStarflightAssets::Shutdown()
+{
+	MiniEarthData.Empty();
+	LofiEarthData.Empty();
+}
+
+TArray<uint8> FStarflightAssets::GetMiniEarthData(int32& OutWidth, int32& OutHeight)
+{
+	OutWidth = MiniEarthWidth;
+	OutHeight = MiniEarthHeight;
+	return MiniEarthData;
+}
+
+TArray<uint8> FStarflightAssets::GetLofiEarthData(int32& OutWidth, int32& OutHeight)
+{
+	OutWidth = LofiEarthWidth;
+	OutHeight = LofiEarthHeight;
+	return LofiEarthData;
+}
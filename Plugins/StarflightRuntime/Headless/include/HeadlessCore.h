@@ -0,0 +1,71 @@
+#pragma once
+
+// Minimal stand-ins for the few Unreal types and macros the emulator core
+// uses, so Emulator/ builds without the engine. Only on the include path of
+// the CMake build, never of the UE module.
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifndef STARFLIGHTRUNTIME_API
+#define STARFLIGHTRUNTIME_API
+#endif
+
+typedef uint8_t  uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+typedef int8_t   int8;
+typedef int16_t  int16;
+typedef int32_t  int32;
+typedef int64_t  int64;
+typedef char     TCHAR;
+
+using FString = std::string;
+
+template<typename T>
+class TArray : public std::vector<T>
+{
+public:
+    int32 Num() const { return (int32)this->size(); }
+    T* GetData() { return this->data(); }
+    const T* GetData() const { return this->data(); }
+    void SetNum(int32 n) { this->resize(n); }
+    void Empty() { this->clear(); }
+};
+
+// ------------------------------------------------
+// Logging
+// ------------------------------------------------
+
+enum class ELogVerbosity : uint8
+{
+    NoLogging = 0,
+    Fatal,
+    Error,
+    Warning,
+    Display,
+    Log,
+    Verbose,
+    VeryVerbose,
+    All = VeryVerbose
+};
+
+// Messages above this level are dropped. Fatal always aborts.
+void HeadlessSetLogVerbosity(ELogVerbosity verbosity);
+void HeadlessLog(const char* category, ELogVerbosity verbosity, const char* format, ...);
+
+#define TEXT(x) x
+#define ANSI_TO_TCHAR(x) (x)
+#define UTF8_TO_TCHAR(x) (x)
+#define TCHAR_TO_UTF8(x) (x)
+
+#define DEFINE_LOG_CATEGORY_STATIC(CategoryName, DefaultVerbosity, CompileTimeVerbosity) \
+    static const char* const CategoryName = #CategoryName;
+
+#define UE_LOG(CategoryName, Verbosity, Format, ...) \
+    HeadlessLog(CategoryName, ELogVerbosity::Verbosity, Format, ##__VA_ARGS__)
+
+#define checkf(expr, Format, ...) \
+    do { if (!(expr)) HeadlessLog("Check", ELogVerbosity::Fatal, Format, ##__VA_ARGS__); } while (0)
@@ -16,17 +16,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <direct.h> // for _getcwd on Windows
-#if defined(_WIN32)
-#include <io.h>
-#include <fcntl.h>
-#include <sys/stat.h>
-#endif
 #include "cpu/cpu.h"
 #include "fract.h"
 #include "graphics.h"
 #include "callstack.h"
 #include "findword.h"
+#include "primitives.h"
+#include "calltrace.h"
+#include "context.h"
 
 // Unreal Engine logging and assets
 #include <stdarg.h>
@@ -39,7 +36,7 @@ DEFINE_LOG_CATEGORY_STATIC(LogStarflightEmulator, Log, All);
 // Simple wrapper to redirect printf-style logging to UE
 static void SF_Log(const char* Format, ...)
 {
-	static char Buffer[4096];
+	static thread_local char Buffer[4096];
 	va_list Args;
 	va_start(Args, Format);
 	vsnprintf(Buffer, sizeof(Buffer), Format, Args);
@@ -56,28 +53,6 @@ static void SF_Log(const char* Format, ...)
 #include "util/lodepng.h"
 #include "tts/speech.h"
 
-// Extremely fast append-only trace for hot-path "Call:" logs.
-// Writes to call_trace.txt so it can be tailed externally.
-static void SF_FastCallTrace(unsigned short addr, unsigned short bx, const char* overlayName, unsigned short forthIp)
-{
-	static int s_fd = -1;
-	if (s_fd == -1)
-	{
-		// Allow readers to tail while we write; append-only, binary mode to avoid translations.
-		_sopen_s(&s_fd, "c:/temp/call_trace.txt", _O_APPEND | _O_CREAT | _O_WRONLY | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE);
-	}
-	if (s_fd != -1)
-	{
-		char buf[128];
-		const char* ov = overlayName ? overlayName : "?";
-		int len = _snprintf_s(buf, sizeof(buf), _TRUNCATE, "Call: si=0x%04x, ov=%s, addr=0x%04x, bx=0x%04x\r\n", forthIp, ov, addr, bx);
-		if (len > 0)
-		{
-			_write(s_fd, buf, len);
-		}
-	}
-}
-
 #include "starsystem.h"
 #include "instance.h"
 
@@ -85,6 +60,7 @@ static void SF_FastCallTrace(unsigned short addr, unsigned short bx, const char*
 #include <assert.h>
 #include <filesystem>
 #include <string>
+#include <cstring>
 #include <algorithm>
 #include <vector>
 #include <iomanip>
@@ -99,13 +75,17 @@ static void SF_FastCallTrace(unsigned short addr, unsigned short bx, const char*
 
 #include "vstrace.h"
 
+#ifdef _WIN32
 extern "C" __declspec(dllimport) void __stdcall OutputDebugStringA(const char* lpOutputString);
+#else
+static void OutputDebugStringA(const char* lpOutputString) { fputs(lpOutputString, stderr); }
+#endif
 
 using namespace Diligent;
 
-// Global stub instance
-FrameSync frameSync;
-static bool s_shouldRecordText = false;
+// Bound per thread by EmulatorContext::MakeCurrent(), see context.h
+thread_local FrameSync* frameSync = nullptr;
+static thread_local bool s_shouldRecordText = false;
 
 // Forward declarations
 static FStarflightEmulatorState ComputeHighLevelState();
@@ -121,7 +101,7 @@ static FStarflightEmulatorState ComputeHighLevelState()
     }
 
     // 1) Splash logos and starport Port-Pic are driven by RunBitPixel tags.
-    switch (frameSync.lastRunBitTag)
+    switch (frameSync->lastRunBitTag)
     {
         case 141: // First splash logo
             return FStarflightEmulatorState::LOGO1;
@@ -130,7 +110,7 @@ static FStarflightEmulatorState ComputeHighLevelState()
         case 44:  // Port-Pic top
         case 49:  // Port-Pic bottom
             // Only treat as station while in starport context and not maneuvering away
-            if (frameSync.gameContext == 5 && !frameSync.maneuvering)
+            if (frameSync->gameContext == 5 && !frameSync->maneuvering)
             {
                 return FStarflightEmulatorState::Station;
             }
@@ -140,25 +120,25 @@ static FStarflightEmulatorState ComputeHighLevelState()
     }
 
     // 2b) Encounter context
-    if (frameSync.gameContext == 4)
+    if (frameSync->gameContext == 4)
     {
         return FStarflightEmulatorState::Encounter;
     }
 
     // 2) Game options overlay
-    if (frameSync.inGameOps)
+    if (frameSync->inGameOps)
     {
         return FStarflightEmulatorState::GameOps;
     }
 
     // 3) Starmap overlay
-    if (frameSync.inDrawStarMap)
+    if (frameSync->inDrawStarMap)
     {
         return FStarflightEmulatorState::Starmap;
     }
 
     // 4) Orbit phases mapped from GraphicsSetOrbitState calls
-    switch (frameSync.currentOrbitState)
+    switch (frameSync->currentOrbitState)
     {
         case OrbitState::Insertion:
         case OrbitState::Landing:
@@ -173,24 +153,24 @@ static FStarflightEmulatorState ComputeHighLevelState()
     }
 
     // 5b) InFlux (inside flux effect overlay)
-    if (frameSync.inFlux)
+    if (frameSync->inFlux)
     {
         return FStarflightEmulatorState::InFlux;
     }
 
     // 5) Navigation – distinguish intra / inter stellar by gameContext
     // ( 0 = planet surface, 1=orbit, 2=system, 3=hyperspace, 4=encounter, 5=starport)
-    if (frameSync.gameContext == 2)
+    if (frameSync->gameContext == 2)
     {
         return FStarflightEmulatorState::IntrastellarNavigation;
     }
-    if (frameSync.gameContext == 3)
+    if (frameSync->gameContext == 3)
     {
         return FStarflightEmulatorState::InterstellarNavigation;
     }
 
     // 6) Landed on a planet surface
-    if (frameSync.gameContext == 0 && frameSync.currentPlanet != 0)
+    if (frameSync->gameContext == 0 && frameSync->currentPlanet != 0)
     {
         return FStarflightEmulatorState::OrbitLanded;
     }
@@ -201,7 +181,7 @@ static FStarflightEmulatorState ComputeHighLevelState()
 // Compute high-level state and publish to Unreal when it changes
 static void UpdateAndEmitStatus()
 {
-    static FStarflightEmulatorState s_lastState = FStarflightEmulatorState::Off;
+    static thread_local FStarflightEmulatorState s_lastState = FStarflightEmulatorState::Off;
 
     FStarflightEmulatorState newState = ComputeHighLevelState();
     if (newState == s_lastState)
@@ -213,8 +193,8 @@ static void UpdateAndEmitStatus()
 
     FStarflightStatus status;
     status.State = newState;
-    status.GameContext = frameSync.gameContext;
-    status.LastRunBitTag = static_cast<uint16_t>(frameSync.lastRunBitTag);
+    status.GameContext = frameSync->gameContext;
+    status.LastRunBitTag = static_cast<uint16_t>(frameSync->lastRunBitTag);
 
     EmitStatus(status);
 
@@ -229,21 +209,21 @@ unsigned int debuglevel = 0;
 const unsigned short cs = StarflightBaseSegment;
 const unsigned short ds = StarflightBaseSegment;
 
-unsigned short int regdi = REGDI; // points to word "OPERATOR"
-unsigned short int cx = 0x0;
-unsigned short int dx = 0x0;
+thread_local unsigned short int regdi = REGDI; // points to word "OPERATOR"
+thread_local unsigned short int cx = 0x0;
+thread_local unsigned short int dx = 0x0;
 
-static uint16_t CurrentImageTagForHybridBlit = 0;
+static thread_local uint16_t CurrentImageTagForHybridBlit = 0;
 
 // Define global variables for serialization
-std::vector<uint8_t> serializedRotoscope;
-std::vector<uint8_t> serializedSnapshot;
-std::vector<uint8_t> planet_image(planet_contour_width* planet_contour_height* planet_usable_width* planet_usable_height);
-std::vector<uint32_t> planet_albedo(planet_contour_width* planet_contour_height* planet_usable_width* planet_usable_height);
+thread_local std::vector<uint8_t> serializedRotoscope;
+thread_local std::vector<uint8_t> serializedSnapshot;
+thread_local std::vector<uint8_t> planet_image(planet_contour_width* planet_contour_height* planet_usable_width* planet_usable_height);
+thread_local std::vector<uint32_t> planet_albedo(planet_contour_width* planet_contour_height* planet_usable_width* planet_usable_height);
 
 // ------------------------------------------------
 
-std::deque<uint16_t> inputbuffer{};
+thread_local std::deque<uint16_t> inputbuffer{};
 
 uint32_t ToAlbedo(const uint8_t* palette, int val)
 {
@@ -341,11 +321,6 @@ void PrintCache()
 
 // ------------------------------------------------
 
-uint8_t STARA[256000];
-uint8_t STARA_ORIG[256000];
-uint8_t STARB[362496];
-uint8_t STARB_ORIG[362496];
-
 std::vector<uint8_t> CompressData(const uint8_t* data, size_t dataSize, size_t& compressedSize) {
     size_t const bufferCapacity = ZSTD_compressBound(dataSize); // Maximum compressed size
     std::vector<uint8_t> compressedData(bufferCapacity);
@@ -387,8 +362,9 @@ void ApplyDifferentialData(uint8_t* data, const std::vector<uint8_t>& diffData,
 bool Serialize(const std::vector<uint8_t>& rotoscopeData, const std::vector<uint8_t>& screenshotData, uint64_t& combinedHash, std::string& filename)
 {
     // Calculate hashes for STARA and STARB as before
-    uint64_t hashA = XXH64(STARA, sizeof(STARA), 0);
-    combinedHash = XXH64(STARB, sizeof(STARB), hashA);
+    EmulatorContext& context = EmulatorContext::Current();
+    uint64_t hashA = XXH64(context.stara.data(), context.stara.size(), 0);
+    combinedHash = XXH64(context.starb.data(), context.starb.size(), hashA);
 
     // Generate filename based on combined hash
     std::stringstream ss;
@@ -426,8 +402,8 @@ bool Serialize(const std::vector<uint8_t>& rotoscopeData, const std::vector<uint
     };
 
     // Serialize and write each section
-    writeSection(CreateDifferentialData(STARA, STARA_ORIG, sizeof(STARA)), archiveHeader.staraHeader, true);
-    writeSection(CreateDifferentialData(STARB, STARB_ORIG, sizeof(STARB)), archiveHeader.starbHeader, true);
+    writeSection(CreateDifferentialData(context.stara.data(), context.staraOrig.data(), context.stara.size()), archiveHeader.staraHeader, true);
+    writeSection(CreateDifferentialData(context.starb.data(), context.starbOrig.data(), context.starb.size()), archiveHeader.starbHeader, true);
     writeSection(rotoscopeData, archiveHeader.rotoscopeHeader, true); // Compress roto-scoped data
     writeSection(screenshotData, archiveHeader.screenshotHeader, false); // Directly write the screenshot data
 
@@ -477,11 +453,12 @@ bool Deserialize(std::filesystem::path filename, std::vector<uint8_t>& rotoscope
     };
 
     // Deserialize each section
+    EmulatorContext& context = EmulatorContext::Current();
     std::vector<uint8_t> staraDiffData = readSection(archiveHeader.staraHeader);
-    ApplyDifferentialData(STARA, staraDiffData, STARA_ORIG, sizeof(STARA));
+    ApplyDifferentialData(context.stara.data(), staraDiffData, context.staraOrig.data(), context.stara.size());
 
     std::vector<uint8_t> starbDiffData = readSection(archiveHeader.starbHeader);
-    ApplyDifferentialData(STARB, starbDiffData, STARB_ORIG, sizeof(STARB));
+    ApplyDifferentialData(context.starb.data(), starbDiffData, context.starbOrig.data(), context.starb.size());
 
     rotoscopeData = readSection(archiveHeader.rotoscopeHeader);
     screenshotData = readSection(archiveHeader.screenshotHeader, false);
@@ -492,8 +469,8 @@ bool Deserialize(std::filesystem::path filename, std::vector<uint8_t>& rotoscope
 
 void HandleInterrupt()
 {
-    static int disktransferaddress_segment = -1;
-    static int disktransferaddress_offset = -1;
+    static thread_local int disktransferaddress_segment = -1;
+    static thread_local int disktransferaddress_offset = -1;
    
     #pragma pack(push, 1)
     struct FCB {
@@ -582,11 +559,11 @@ void HandleInterrupt()
         uint8_t* fileTarget = nullptr;
         if(filename == "STARA")
         {
-            fileTarget = (uint8_t*)&STARA[offset];
+            fileTarget = &EmulatorContext::Current().stara[offset];
         }
         else if(filename == "STARB")
         {
-            fileTarget = (uint8_t*)&STARB[offset];
+            fileTarget = &EmulatorContext::Current().starb[offset];
         }
         else
         {
@@ -616,11 +593,11 @@ void HandleInterrupt()
         const uint8_t* fileSource = nullptr;
         if(filename == "STARA")
         {
-            fileSource = (const uint8_t*)&STARA[offset];
+            fileSource = &EmulatorContext::Current().stara[offset];
         }
         else if(filename == "STARB")
         {
-            fileSource = (const uint8_t*)&STARB[offset];
+            fileSource = &EmulatorContext::Current().starb[offset];
         }
         else
         {
@@ -631,6 +608,7 @@ void HandleInterrupt()
         size_t recordSizeBytes = fcb->recordSize;
 
         memcpy(dataTarget, fileSource, recordSizeBytes);
+        GraphicsTextWritten((disktransferaddress_segment<<4)+disktransferaddress_offset, (uint32_t)recordSizeBytes);
 
         SF_Log("Read %s block=%zu size=%zu\n", filename.c_str(), offset, recordSizeBytes);
 
@@ -775,7 +753,7 @@ void LXCHG8(unsigned short es, unsigned short bx, unsigned short ax)
 // 0x49d6: mov    es:[bx],cl
 }
 
-static std::stack<bool> s_disableForthMeasurements{};
+static thread_local std::stack<bool> s_disableForthMeasurements{};
 
 RETURNCODE LoadData(uint16_t word)
 {
@@ -956,32 +934,66 @@ const unsigned short int pp_IRIGHT = 0x5745; // IRIGHT size: 2
 const unsigned short int pp_IBELOW = 0x5752; // IBELOW size: 2
 const unsigned short int pp_IABOVE = 0x575f; // IABOVE size: 2
 
-static void ClippedGraphicsPixel(int x, int y, int color, uint32_t offset, Rotoscope pc) {
-    // Assume GetBoundaryValue is a function or a mechanism to retrieve the stored values
-    // for the clipping boundaries from their respective addresses or variables.
-    int16_t leftBoundary = (int16_t)Read16(pp_ILEFT);
-    int16_t rightBoundary = (int16_t)Read16(pp_IRIGHT);
-    int16_t topBoundary = (int16_t)Read16(pp_IABOVE);
-    int16_t bottomBoundary = (int16_t)Read16(pp_IBELOW);
+// Window that ELLIPSE_INTEGER clips against, inclusive, y up
+struct ClipWindow
+{
+    int16_t left, right, top, bottom;
+
+    static ClipWindow Read()
+    {
+        return { (int16_t)Read16(pp_ILEFT), (int16_t)Read16(pp_IRIGHT), (int16_t)Read16(pp_IABOVE), (int16_t)Read16(pp_IBELOW) };
+    }
+};
 
-    if (x >= leftBoundary && x <= rightBoundary && y >= bottomBoundary && y <= topBoundary) {
+static void ClippedGraphicsPixel(const ClipWindow& clip, int x, int y, int color, uint32_t offset, const Rotoscope& pc) {
+    if (x >= clip.left && x <= clip.right && y >= clip.bottom && y <= clip.top) {
         GraphicsPixel(x, y, color, offset, pc);
     }
 }
 
+static void ClippedGraphicsSpan(const ClipWindow& clip, int y, int x0, int x1, int color, uint32_t offset, const Rotoscope& pc) {
+    if (y >= clip.bottom && y <= clip.top) {
+        GraphicsFillSpan(y, std::max(x0, (int)clip.left), std::min(x1, (int)clip.right), color, offset, pc);
+    }
+}
+
 void ELLIPSE_INTEGER(int x_center, int y_center, int XRadius, int YRadius, int color, int seg, bool fill)
 {
     Rotoscope pixelType = Rotoscope(EllipsePixel);
 
-    if(frameSync.inDrawAuxSys)
+    if(frameSync->inDrawAuxSys)
     {
         pixelType = Rotoscope(AuxSysPixel);
     }
-    else if (frameSync.inDrawStarMap)
+    else if (frameSync->inDrawStarMap)
     {
         pixelType = Rotoscope(StarMapPixel);
     }
 
+    const ClipWindow clip = ClipWindow::Read();
+
+    // Midpoint ellipse. Filled, every step covers the rows y_center +- y from
+    // x_center - x to x_center + x. Those spans nest, so a row only needs its
+    // widest one.
+    auto plot = [&](int x, int y)
+    {
+        if(fill)
+        {
+            ClippedGraphicsSpan(clip, y_center + y, x_center - x, x_center + x, color, seg, pixelType);
+            if (y != 0)
+            {
+                ClippedGraphicsSpan(clip, y_center - y, x_center - x, x_center + x, color, seg, pixelType);
+            }
+        }
+        else
+        {
+            ClippedGraphicsPixel(clip, x_center + x, y_center + y, color, seg, pixelType);
+            ClippedGraphicsPixel(clip, x_center - x, y_center + y, color, seg, pixelType);
+            ClippedGraphicsPixel(clip, x_center + x, y_center - y, color, seg, pixelType);
+            ClippedGraphicsPixel(clip, x_center - x, y_center - y, color, seg, pixelType);
+        }
+    };
+
     int XRadiusSq = XRadius * XRadius;
     int YRadiusSq = YRadius * YRadius;
     int twoXRadiusSq = 2 * XRadiusSq;
@@ -994,23 +1006,10 @@ void ELLIPSE_INTEGER(int x_center, int y_center, int XRadius, int YRadius, int c
     int stoppingX = twoYRadiusSq * XRadius;
     int stoppingY = 0;
 
+    // y moves every step here
     while (stoppingX >= stoppingY)
     {
-        if(fill)
-        {
-            for (int i = x_center - x; i <= x_center + x; i++)
-            {
-                ClippedGraphicsPixel(i, y_center + y, color, seg, pixelType);
-                ClippedGraphicsPixel(i, y_center - y, color, seg, pixelType);
-            }
-        }
-        else
-        {
-            ClippedGraphicsPixel(x_center + x, y_center + y, color, seg, pixelType);
-            ClippedGraphicsPixel(x_center - x, y_center + y, color, seg, pixelType);
-            ClippedGraphicsPixel(x_center + x, y_center - y, color, seg, pixelType);
-            ClippedGraphicsPixel(x_center - x, y_center - y, color, seg, pixelType);
-        }
+        plot(x, y);
 
         y++;
         stoppingY += twoXRadiusSq;
@@ -1034,22 +1033,13 @@ void ELLIPSE_INTEGER(int x_center, int y_center, int XRadius, int YRadius, int c
     stoppingX = 0;
     stoppingY = twoXRadiusSq * YRadius;
 
+    // x grows every step here, so a filled row is drawn once y is about to move
     while (stoppingX <= stoppingY)
     {
-        if(fill)
+        const int rowY = y;
+        if(!fill)
         {
-            for (int i = x_center - x; i <= x_center + x; i++)
-            {
-                ClippedGraphicsPixel(i, y_center + y, color, seg, pixelType);
-                ClippedGraphicsPixel(i, y_center - y, color, seg, pixelType);
-            }
-        }
-        else
-        {
-            ClippedGraphicsPixel(x_center + x, y_center + y, color, seg, pixelType);
-            ClippedGraphicsPixel(x_center - x, y_center + y, color, seg, pixelType);
-            ClippedGraphicsPixel(x_center + x, y_center - y, color, seg, pixelType);
-            ClippedGraphicsPixel(x_center - x, y_center - y, color, seg, pixelType);
+            plot(x, y);
         }
 
         x++;
@@ -1064,6 +1054,11 @@ void ELLIPSE_INTEGER(int x_center, int y_center, int XRadius, int YRadius, int c
             ellipseError += yChange;
             yChange += twoXRadiusSq;
         }
+
+        if(fill && (y != rowY || stoppingX > stoppingY))
+        {
+            plot(x - 1, rowY);
+        }
     }
 }
 
@@ -1257,9 +1252,9 @@ union MusicPlayer {
     };
 };
 
-static std::jthread s_musicThread{};
-static std::atomic<bool> s_musicThreadShouldExit{false};
-static MusicPlayer s_player;
+static thread_local std::jthread s_musicThread{};
+static thread_local std::atomic<bool> s_musicThreadShouldExit{false};
+static thread_local MusicPlayer s_player;
 uint8_t frequencyLookupTable[] = {
 0xf0, 0xfd, 0xf8, 0x7e, 0x7c, 0x3f, 0xbe, 0x1f, 0xfd, 0x0f, 0xef, 0x07, 0xf7, 
 0x03, 0xfb, 0x01, 0xb1, 0xef, 0xd8, 0x77, 0xec, 0x3b, 0xf6, 0x1d, 0xfb, 0x0e, 
@@ -1424,96 +1419,182 @@ uint16_t Peek16(uint16_t stackOffset) {
 
 // Define global variable for emulation control (shared elsewhere)
 extern std::atomic<bool> stopEmulationThread;
-uint16_t nparmsStackSi = 0;
-
-static uint64_t s_missileNonce = 0x1000000;
-static bool s_secondFlag = false;
-static std::string s_recordedText = "";
-static std::vector<Icon> s_currentIconList;
-static std::vector<Icon> s_currentSolarSystem;
-static std::vector<MissileRecordUnique> s_missiles;
-static std::vector<LaserRecord> s_lasers;
-static std::vector<Explosion> s_explosions;
-static StarMapSetup s_currentStarMap;
-static uint16_t s_orbitMask;
-static vec2<int16_t> s_heading;
-static std::unordered_map<uint16_t, uint64_t> s_missileIds;
-
-uint64_t s_targetFrameKey = 0;
+thread_local uint16_t nparmsStackSi = 0;
+
+static thread_local uint64_t s_missileNonce = 0x1000000;
+static thread_local bool s_secondFlag = false;
+static thread_local std::string s_recordedText = "";
+static thread_local std::vector<Icon> s_currentIconList;
+static thread_local std::vector<Icon> s_currentSolarSystem;
+static thread_local std::vector<MissileRecordUnique> s_missiles;
+static thread_local std::vector<LaserRecord> s_lasers;
+static thread_local std::vector<Explosion> s_explosions;
+static thread_local StarMapSetup s_currentStarMap;
+static thread_local uint16_t s_orbitMask;
+static thread_local vec2<int16_t> s_heading;
+static thread_local std::unordered_map<uint16_t, uint64_t> s_missileIds;
+
+thread_local uint64_t s_targetFrameKey = 0;
 
-enum RETURNCODE Call(unsigned short addr, unsigned short bx)
-{
-    if (stopEmulationThread)
-        return STOP;
+// ------------------------------------------------
+// Word dispatch
+//
+// Words without side effects beyond the Forth machine state are resolved
+// once into s_wordHandlers and run directly from Call(). Everything else
+// goes through the big switch in CallWord(). Debug bookkeeping lives in
+// CallInstrumented() and only runs when enabled.
+// ------------------------------------------------
 
-    // CPU registers are globals (match original emulator semantics)
-    
-    unsigned short i;
-    enum RETURNCODE ret = OK;
+static NativePrimitive s_wordHandlers[0x10000];
+static std::once_flag s_wordHandlersOnce;
+static bool s_instrumentCalls = false;
 
-    regbx = bx;
+static void RegisterWordHandlers()
+{
+    static const struct { uint16_t addr; NativePrimitive handler; } s_simpleWords[] =
+    {
+        { 0x1D29, []() { Push(regbx + 2); } }, // variable
+        { 0x2214, []() { Push(Read16(regbx + 2)); } }, // constant
+        { 0x1662, []() { regsi += Read16(regsi); } }, // BRANCH
+        { 0x15FC, []() { if (Pop() == 0) regsi += Read16(regsi); else regsi += 2; } }, // 0BRANCH
+        { 0x0E52, []() { Push(Read16(regbp+0)); } }, // "I"
+        { 0x0E62, []() { Push(Read16(regbp+2)); } }, // "I'"
+        { 0x0E70, []() { Push(Read16(regbp+4)); } }, // "J"
+        { 0x0EA4, []() { Push(Read16(regbp+0)); } }, // "R@"
+        { 0x0E92, []() { Push(Read16(regbp)); regbp += 2; } }, // "R>"
+        { 0x0E34, []() { Pop(); } }, // "DROP"
+        { 0x0DE0, []() { Pop(); Pop(); } }, // "2DROP"
+        { 0x0E81, []() { Push(Read16(regsp+2)); } }, // "OVER"
+        { 0x0E43, []() { Push(Read16(regsp)); } }, // "DUP"
+        { 0x0DF2, []() { unsigned short bx = regsp; Push(Read16(bx+2)); Push(Read16(bx)); } }, // "2DUP"
+        { 0x0DCA, []() { if (Read16(regsp) != 0) Push(Read16(regsp)); } }, // "?DUP"
+        { 0x0c17, []() { Push(cs); } }, // "(CS?)"
+        { 0x0F14, []() { Push(regsp); } }, // "SP@"
+        { 0x49c2, []() { Push(ds); } }, // "@DS"
+        { 0x0ad1, []() { Push(regdi); } }, // "ME"
+        { 0x4873, []() { Write16(Pop(), 1); } }, // ON
+        { 0x4886, []() { Write16(Pop(), 0); } }, // "OFF"
+        { 0x0D7C, []() { Push((Pop()-cs)<<4); } }, // "SEG>ADDR"
+    };
 
-    auto divideByZero = [&](int16_t& quotient, int16_t& remainder){
-        // 0x01C4:                 pop     ax
-        // 0x01C5:                 inc     ax
-        // 0x01C6:                 push    ax
-        // 0x01C7:                 sub     ax, ax
-        // 0x01C9:                 sub     dx, dx
-        // 0x01CB:                 iret
-        // 0x01CC: ; ---------------------------------------------------------------------------
-        // 0x01CC:                 xor     bx, bx
-        // 0x01CE:                 div     bx
-        // 0x01D0:                 retn
-        // 0x01d1: ; ---------------------------------------------------------------------------
-        // 0x01d1: pop    ax
-        // 0x01d2: mov    cx,ax
-        // 0x01d4: sub    ax,01D0
-        // 0x01d8: jnz    01E0
-        // 0x01da: mov    ax,01C7
-        // 0x01dd: jmp    01E4
-        // 0x01e0: mov    ax,01C4
-        // 0x01e3: inc    cx
-        // 0x01e4: mov    dx,ds
-        // 0x01e6: xor    bx,bx
-        // 0x01e8: mov    ds,bx
-        // 0x01ea: mov    [bx],ax
-        // 0x01ec: mov    ds,dx
-        // 0x01ee: push   cx
-        // 0x01ef: iret
-        // 0x01fa: mov    ax,ds
-        // 0x01fc: xor    bx,bx
-        // 0x01fe: mov    ds,bx
-        // 0x0200: mov    word ptr [bx],01D1
-        // 0x0204: add    bx,0002
-        // 0x0208: mov    [bx],ax
-        // 0x020a: mov    ds,ax
-        // 0x020c: call   01CC
-        // 0x020f: lodsw
-        // 0x0210: mov    bx,ax
-        // 0x0212: jmp    word ptr [bx]
-        
-        SF_Log("Integer divide by zero\n");
+    for (const auto& word : s_simpleWords)
+    {
+        s_wordHandlers[word.addr] = word.handler;
+    }
 
-        if(false)
+    for (uint32_t addr = 0; addr < 0x10000; addr++)
+    {
+        if (NativePrimitive primitive = FindNativePrimitive((uint16_t)addr))
         {
-            // This code is exhibited in the divide by zero handler. Not sure of its purpose.
-            auto val = Pop();
-            ++val;
-            Push(val);
+            s_wordHandlers[addr] = primitive;
         }
+    }
+}
 
-        quotient = 0;
-        remainder = 0;
-    };
+void EnableCallInstrumentation(bool enable)
+{
+    s_instrumentCalls = enable;
+}
+
+uint64_t GetWordsExecuted()
+{
+    return EmulatorContext::Current().wordsExecuted.load(std::memory_order_relaxed);
+}
+
+uint64_t GetWordsPerSecond()
+{
+    return EmulatorContext::Current().wordsPerSecond.load(std::memory_order_relaxed);
+}
+
+// ------------------------------------------------
+// Clock
+//
+// With a virtual clock, "TIME" is derived from the word counter and sleeps
+// only advance it, so a run with the same input executes the same words.
+// ------------------------------------------------
+
+void SetVirtualClock(uint32_t wordsPerMillisecond)
+{
+    EmulatorContext::Current().virtualClockWordsPerMs.store(wordsPerMillisecond, std::memory_order_relaxed);
+}
 
-    if (graphicsIsShutdown)
+uint64_t GetClockMilliseconds()
+{
+    EmulatorContext& context = EmulatorContext::Current();
+    uint32_t wordsPerMs = context.virtualClockWordsPerMs.load(std::memory_order_relaxed);
+    if (wordsPerMs != 0)
     {
-        return STOP;
+        return context.wordsExecuted.load(std::memory_order_relaxed) / wordsPerMs + context.virtualSleepMs.load(std::memory_order_relaxed);
+    }
+
+    auto now = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+}
+
+static void EmulatorSleep(std::chrono::milliseconds duration)
+{
+    EmulatorContext& context = EmulatorContext::Current();
+    if (context.virtualClockWordsPerMs.load(std::memory_order_relaxed) != 0)
+    {
+        context.virtualSleepMs.fetch_add(duration.count(), std::memory_order_relaxed);
+        return;
+    }
+    std::this_thread::sleep_for(duration);
+}
+
+static void UpdateWordsPerSecond()
+{
+    static thread_local auto s_lastTime = std::chrono::steady_clock::now();
+    static thread_local uint64_t s_lastCount = 0;
+    static thread_local int s_seconds = 0;
+
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - s_lastTime).count();
+    if (elapsed < 1000)
+        return;
+
+    uint64_t count = GetWordsExecuted();
+    uint64_t wordsPerSecond = (count - s_lastCount) * 1000 / elapsed;
+    EmulatorContext::Current().wordsPerSecond.store(wordsPerSecond, std::memory_order_relaxed);
+    s_lastCount = count;
+    s_lastTime = now;
+
+    if (++s_seconds % 10 == 0)
+    {
+        SF_Log("Forth words/sec: %llu\n", (unsigned long long)wordsPerSecond);
     }
+}
+
+static enum RETURNCODE CallWord(unsigned short addr, unsigned short bx);
+
+// Bookkeeping done for every word, handler or not: the frame-sync state the presenter follows and the
+// parameter stack range check. Returns false if the stack pointer is out of range
+static bool EnterWord(unsigned short bx, int ovidx)
+{
+    // Track whether we're currently inside a flux effect module
+    // Overlay index 0x6d in directory.h is "FLUX-EFFECT ".
+    frameSync->inFlux = (ovidx == 0x6d);
 
     {
-        static uint16_t s_xabs = 0;
-        static uint16_t s_yabs = 0;
+        frameSync->gameContext = Read16(0x5a5c);
+    }
+
+    // bx contains pointer to WORD
+    if ((regsp < FILESTAR0SIZE+0x100) || (regsp > (0xF6F4)))
+    {
+        SF_Log("Error: stack pointer in invalid area: sp=0x%04x\n", regsp);
+        PrintCallstacktrace(bx);
+        assert(false);
+        return false;
+    }
+    return true;
+}
+
+static enum RETURNCODE CallInstrumented(unsigned short addr, unsigned short bx)
+{
+    {
+        static thread_local uint16_t s_xabs = 0;
+        static thread_local uint16_t s_yabs = 0;
 
         const unsigned short int pp_XABS = 0x5dae; // XABS size: 2
         const unsigned short int pp_YABS = 0x5db9; // YABS size: 2
@@ -1527,20 +1608,8 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
         }
     }
 
-    const char* baseOverlay = "";
-    const char* baseWord = "";
-    const char* overlayName = baseOverlay;
-    const char* wordName = baseWord;
-    uint16_t    wordValue = 0;
-
-    int ovidx = GetOverlayIndex(Read16(0x55a5), &overlayName);
-    wordName = FindWordCanFail(bx + 2, ovidx, true);
-    overlayName = GetOverlayName(ovidx);
-    wordValue = bx + 2;
-
-    // Track whether we're currently inside a flux effect module
-    // Overlay index 0x6d in directory.h is "FLUX-EFFECT ".
-    frameSync.inFlux = (ovidx == 0x6d);
+    int ovidx = GetCurrentOverlayIndex();
+    const char* wordName = FindWordCanFail(bx + 2, ovidx, true);
 
     struct WordTime
     {
@@ -1548,14 +1617,14 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
         std::chrono::high_resolution_clock::time_point start;
     };
 
-    static std::deque<WordTime> wordDeque;
+    static thread_local std::deque<WordTime> wordDeque;
     struct WordTracker
     {
         WordTracker(const std::string& word)
         {
             wordDeque.push_back({word, std::chrono::high_resolution_clock::now()});
 
-            if(frameSync.maneuvering)
+            if(frameSync->maneuvering)
             {
                 if (word == "?TERMINAL")
                 {
@@ -1573,7 +1642,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
         }
         ~WordTracker()
         {
-            if(frameSync.maneuvering)
+            if(frameSync->maneuvering)
             {
                 auto end = std::chrono::high_resolution_clock::now();
                 auto time = std::chrono::duration_cast<std::chrono::microseconds>(end - wordDeque.back().start);
@@ -1595,26 +1664,106 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
     };
     WordTracker tracker(wordName);
 
-    static auto lastTime = std::chrono::high_resolution_clock::now();
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(currentTime - lastTime);
+    return CallWord(addr, bx);
+}
 
-    lastTime = currentTime;
+enum RETURNCODE Call(unsigned short addr, unsigned short bx)
+{
+    if (stopEmulationThread || IsGraphicsShutdown())
+        return STOP;
 
-    {
-        frameSync.gameContext = Read16(0x5a5c);
-    }
+    std::atomic<uint64_t>& counter = EmulatorContext::Current().wordsExecuted;
+    uint64_t wordsExecuted = counter.load(std::memory_order_relaxed) + 1;
+    counter.store(wordsExecuted, std::memory_order_relaxed);
+    if ((wordsExecuted & 0xFFFFF) == 0)
+        UpdateWordsPerSecond();
 
-    // bx contains pointer to WORD
-    if ((regsp < FILESTAR0SIZE+0x100) || (regsp > (0xF6F4)))
+    if (IsCallTraceEnabled())
+        CallTraceWrite(regsi, Read16(0x55a5), addr, bx);
+
+    if (s_instrumentCalls)
+        return CallInstrumented(addr, bx);
+
+    NativePrimitive handler = s_wordHandlers[addr];
+    if (handler != nullptr && !IsPrimitiveVerificationEnabled())
     {
-        SF_Log("Error: stack pointer in invalid area: sp=0x%04x\n", regsp);
-        PrintCallstacktrace(bx);
-        assert(false);
-        return EMULATOR_ERROR;
+        regbx = bx;
+        if (!EnterWord(bx, GetCurrentOverlayIndex()))
+            return EMULATOR_ERROR;
+        handler();
+        return OK;
     }
 
-	SF_FastCallTrace(addr, bx, overlayName, regsi);
+    return CallWord(addr, bx);
+}
+
+static enum RETURNCODE CallWord(unsigned short addr, unsigned short bx)
+{
+    // CPU registers are globals (match original emulator semantics)
+    
+    unsigned short i;
+    enum RETURNCODE ret = OK;
+
+    regbx = bx;
+
+    auto divideByZero = [&](int16_t& quotient, int16_t& remainder){
+        // 0x01C4:                 pop     ax
+        // 0x01C5:                 inc     ax
+        // 0x01C6:                 push    ax
+        // 0x01C7:                 sub     ax, ax
+        // 0x01C9:                 sub     dx, dx
+        // 0x01CB:                 iret
+        // 0x01CC: ; ---------------------------------------------------------------------------
+        // 0x01CC:                 xor     bx, bx
+        // 0x01CE:                 div     bx
+        // 0x01D0:                 retn
+        // 0x01d1: ; ---------------------------------------------------------------------------
+        // 0x01d1: pop    ax
+        // 0x01d2: mov    cx,ax
+        // 0x01d4: sub    ax,01D0
+        // 0x01d8: jnz    01E0
+        // 0x01da: mov    ax,01C7
+        // 0x01dd: jmp    01E4
+        // 0x01e0: mov    ax,01C4
+        // 0x01e3: inc    cx
+        // 0x01e4: mov    dx,ds
+        // 0x01e6: xor    bx,bx
+        // 0x01e8: mov    ds,bx
+        // 0x01ea: mov    [bx],ax
+        // 0x01ec: mov    ds,dx
+        // 0x01ee: push   cx
+        // 0x01ef: iret
+        // 0x01fa: mov    ax,ds
+        // 0x01fc: xor    bx,bx
+        // 0x01fe: mov    ds,bx
+        // 0x0200: mov    word ptr [bx],01D1
+        // 0x0204: add    bx,0002
+        // 0x0208: mov    [bx],ax
+        // 0x020a: mov    ds,ax
+        // 0x020c: call   01CC
+        // 0x020f: lodsw
+        // 0x0210: mov    bx,ax
+        // 0x0212: jmp    word ptr [bx]
+        
+        SF_Log("Integer divide by zero\n");
+
+        if(false)
+        {
+            // This code is exhibited in the divide by zero handler. Not sure of its purpose.
+            auto val = Pop();
+            ++val;
+            Push(val);
+        }
+
+        quotient = 0;
+        remainder = 0;
+    };
+
+    int ovidx = GetCurrentOverlayIndex();
+    const char* overlayName = GetOverlayName(ovidx);
+
+    if (!EnterWord(bx, ovidx))
+        return EMULATOR_ERROR;
 
     switch(addr)
     {
@@ -1669,9 +1818,9 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
                 if(nextInstr == 0xcbbf || (nextInstr == 0xf4bd && (std::string(overlayName) == "COMBAT-OV"))) // MANEUVER
                 {
-                    frameSync.maneuvering = true;
-                    frameSync.maneuveringStartTime = std::chrono::steady_clock::now();
-                    SF_Log("frameSync.maneuvering = true\n");
+                    frameSync->maneuvering = true;
+                    frameSync->maneuveringStartTime = std::chrono::steady_clock::now();
+                    SF_Log("frameSync->maneuvering = true\n");
                 }
 
                 if( nextInstr == 0xe72c && (std::string(overlayName) == "COMBAT-OV")) // COMBAT mdelete (free missiles)
@@ -1717,18 +1866,18 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
                 if(nextInstr == 0xf4dc && (std::string(overlayName) == "GAME-OV")) // >GAMEOPTIONS 
                 {
-                    frameSync.inGameOps = true;
+                    frameSync->inGameOps = true;
                     GraphicsSaveScreen();
                 }
 
                 if(nextInstr == 0xee39 && (std::string(overlayName) == "GAME-OV")) // SAVEGAME 
                 {
-                    frameSync.shouldSave = true;
+                    frameSync->shouldSave = true;
                 }
 
                 if(nextInstr == 0xf3bc) // COMBAT-KEY
                 {
-                    frameSync.inCombatKey = true;
+                    frameSync->inCombatKey = true;
                 }
 
                 if(nextInstr == 0xef5a && (std::string(overlayName) == "GAME-OV")) // SET.DISPLAY.MODE
@@ -1745,14 +1894,14 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                     for(int i = 0; i < 3; ++i)
                     {
                         GraphicsSetDeadReckoning(s_heading.x, s_heading.y, s_currentIconList, s_currentSolarSystem, s_orbitMask, s_currentStarMap, s_missiles, s_lasers, s_explosions);
-                        std::this_thread::sleep_for(std::chrono::milliseconds(25));
+                        EmulatorSleep(std::chrono::milliseconds(25));
                     }
                     #endif
                 }
 
                 if(nextInstr == 0xE500 && (std::string(overlayName) == "COMBAT-OV")) // WE500 
                 {
-                    frameSync.inCombatRender = true;
+                    frameSync->inCombatRender = true;
                     auto shipCount = Read16(0xe1fb);
 
                     auto iconCount = Read16(pp_ILOCAL);
@@ -1791,7 +1940,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
                 if(nextInstr == 0xEAAE) // Clear for starmap
                 {
-                    frameSync.inDrawStarMap = true;
+                    frameSync->inDrawStarMap = true;
                 }
 
                 if(nextInstr == 0xeaa2 && (std::string(overlayName) == "MAP-OV")) // >GAMEOPTIONS 
@@ -1830,7 +1979,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
                 if(nextInstr == 0xe0a3 && (std::string(overlayName) == "HYPER-OV"))
                 {
-                    frameSync.inDrawAuxSys = true;
+                    frameSync->inDrawAuxSys = true;
                 }
 
                 if (nextInstr == 0xe4b6) // (PHRASE>CT)
@@ -1841,12 +1990,12 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
                 if (nextInstr == 0xa705) // INIT-BUTTON
                 {
-                    frameSync.inDrawShipButton = true;
+                    frameSync->inDrawShipButton = true;
                 }
 
                 if (nextInstr == 0xa042) // .1LOGO
                 {
-                    frameSync.inSmallLogo = true;
+                    frameSync->inSmallLogo = true;
                 }
 
                 if (nextInstr == 0xe6f8) // MANEUVER
@@ -1892,13 +2041,13 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
                     auto res = Pop();
                     uint16_t value = Read16(res);
-                    frameSync.currentPlanetMass = value;
+                    frameSync->currentPlanetMass = value;
 
                     value = value / 3; // Divide by 3
                     value = std::max<unsigned short>(value, 20);
                     value = std::min<unsigned short>(value, 120);
 
-                    frameSync.currentPlanetSphereSize = value;
+                    frameSync->currentPlanetSphereSize = value;
 
                     auto planetIt = planets.find(iaddr);
                     assert(planetIt != planets.end());
@@ -2201,7 +2350,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
                     GraphicsInitPlanets(surfaces);
 
-                    frameSync.pastHimus = true;
+                    frameSync->pastHimus = true;
                 }
 
                 if (nextInstr == 0x7339) // FILE<
@@ -2219,7 +2368,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
                 if(nextInstr == 0xe6dc || nextInstr == 0xec65) // WE6DC - Orbit screen copy routine of landing or grid
                 {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    EmulatorSleep(std::chrono::milliseconds(100));
                 }
 
                 if(nextInstr == 0xc3a7) // DESCEND
@@ -2594,8 +2743,8 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                     rs.runBitData.tag = fileNum;
 
                     // Track last RunBit image tag for high-level status (logos, port-pic, etc.)
-                    frameSync.lastRunBitTag = static_cast<uint16_t>(fileNum);
-                    SF_Log("RunBit (CSCR>EGA) tag set to %u", static_cast<unsigned>(frameSync.lastRunBitTag));
+                    frameSync->lastRunBitTag = static_cast<uint16_t>(fileNum);
+                    SF_Log("RunBit (CSCR>EGA) tag set to %u", static_cast<unsigned>(frameSync->lastRunBitTag));
 
                     // Update high-level state immediately after splash/logo load
                     UpdateAndEmitStatus();
@@ -2651,14 +2800,16 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                     s_player.speakerIsOff = 1;
                     s_player.isrEnabled = 1;
 
-                    s_musicThread = std::jthread([&]{
+                    // The player runs on its own thread, so hand it this thread's state
+                    s_musicThread = std::jthread([&player = s_player, &shouldExit = s_musicThreadShouldExit, &context = EmulatorContext::Current()]{
+                        context.MakeCurrent();
                         for (;;) {
-                            if(s_musicThreadShouldExit)
+                            if(shouldExit)
                                 break;
 
                             std::this_thread::sleep_for(std::chrono::microseconds((int)(1000000.0f / 18.2f)));
 
-                            uint16_t noteAddress = s_player.currentNoteAddressInMem;
+                            uint16_t noteAddress = player.currentNoteAddressInMem;
 
                             uint8_t noteDuration = Read8(noteAddress++) & 0x7F;
                             if (noteDuration != 0) {
@@ -2667,40 +2818,40 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                                     noteDuration &= 0x3F;
                                     restDuration++;
                                 }
-                                s_player.noteOnDuration = noteDuration;
-                                s_player.restDuration = restDuration;
+                                player.noteOnDuration = noteDuration;
+                                player.restDuration = restDuration;
                                 uint8_t note = Read8(noteAddress++);
-                                s_player.currentNoteAddressInMem = noteAddress;
+                                player.currentNoteAddressInMem = noteAddress;
                                 if (note == 0xFF) {
-                                    s_player.tickCounter = s_player.noteOnDuration;
+                                    player.tickCounter = player.noteOnDuration;
                                     BeepOff();
-                                    s_player.speakerIsOff = 1;
+                                    player.speakerIsOff = 1;
                                     continue;
                                 }
-                                uint8_t tickDuration = s_player.noteOnDuration - s_player.restDuration;
-                                s_player.tickCounter = tickDuration;
+                                uint8_t tickDuration = player.noteOnDuration - player.restDuration;
+                                player.tickCounter = tickDuration;
                                 BeepTone(frequencyLookupTable[note]);
                                 BeepOn();
-                                s_player.speakerIsOff = 0;
+                                player.speakerIsOff = 0;
                                 continue;
                             }
                             
-                            uint16_t sequenceAddress = s_player.currentSequenceAddressInMem;
-                            --s_player.repeats;
-                            if (s_player.repeats == 0) {
+                            uint16_t sequenceAddress = player.currentSequenceAddressInMem;
+                            --player.repeats;
+                            if (player.repeats == 0) {
                                 sequenceAddress += 3;
                                 uint8_t repeatCount = Read8(sequenceAddress);
                                 if (repeatCount == 0) {
-                                    s_player.isrEnabled = 0;
+                                    player.isrEnabled = 0;
                                     break;
                                 }
-                                s_player.currentSequenceAddressInMem = sequenceAddress;
-                                s_player.repeats = repeatCount;
+                                player.currentSequenceAddressInMem = sequenceAddress;
+                                player.repeats = repeatCount;
                             }
 
-                            s_player.currentNoteAddressInMem = Read16(sequenceAddress + 1);
-                            s_player.tickCounter = 1;
-                            s_player.speakerIsOff = 1;
+                            player.currentNoteAddressInMem = Read16(sequenceAddress + 1);
+                            player.tickCounter = 1;
+                            player.speakerIsOff = 1;
                             BeepOff();
                         }
 
@@ -2820,13 +2971,13 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                         Push(0);
                     }
 
-                    frameSync.inNebula = inNebula;
+                    frameSync->inNebula = inNebula;
                 }
                 else if (nextInstr == 0x2af1)
                 {
                     // Sleep
                     auto sleepInMs = Pop();
-                    std::this_thread::sleep_for(std::chrono::milliseconds(sleepInMs));
+                    EmulatorSleep(std::chrono::milliseconds(sleepInMs));
                     SF_Log("Sleep ms: %d\n", sleepInMs);
                 }
                 else
@@ -2900,25 +3051,25 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
                 if(nextInstr == 0xcbbf || (nextInstr == 0xf4bd && (std::string(overlayName) == "COMBAT-OV"))) // MANEUVER
                 {
-                    frameSync.maneuvering = false;
-                    frameSync.maneuveringEndTime = std::chrono::steady_clock::now();
-                    SF_Log("frameSync.maneuvering = false\n");
+                    frameSync->maneuvering = false;
+                    frameSync->maneuveringEndTime = std::chrono::steady_clock::now();
+                    SF_Log("frameSync->maneuvering = false\n");
                     GraphicsSetDeadReckoning(0, 0, s_currentIconList, s_currentSolarSystem, s_orbitMask, s_currentStarMap, s_missiles, s_lasers, s_explosions);
                 }
 
                 if(nextInstr == 0xf504 && (std::string(overlayName) == "GAME-OV")) // <GAMEOPTIONS 
                 {
-                    frameSync.inGameOps = false;
+                    frameSync->inGameOps = false;
                 }
 
                 if(nextInstr == 0xeaa2 && (std::string(overlayName) == "MAP-OV")) // >GAMEOPTIONS 
                 {
-                    frameSync.inDrawStarMap = false;
+                    frameSync->inDrawStarMap = false;
                 }
 
                 if(nextInstr == 0xf3bc) // COMBAT-KEY
                 {
-                    frameSync.inCombatKey = true;
+                    frameSync->inCombatKey = true;
                 }
 
                 if (nextInstr == 0xdb04) // ORBSETUP
@@ -2931,15 +3082,15 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                     auto planetIt = planets.find(iaddr);
                     assert(planetIt != planets.end());
 
-                    frameSync.currentPlanet = planetIt->second.seed;
-                    frameSync.currentPlanetSphereSize = 100;
+                    frameSync->currentPlanet = planetIt->second.seed;
+                    frameSync->currentPlanetSphereSize = 100;
 
                     GraphicsSetOrbitState(OrbitState::Holding);
                 }
 
                 if (nextInstr == 0xa705) // INIT-BUTTON
                 {
-                    frameSync.inDrawShipButton = false;
+                    frameSync->inDrawShipButton = false;
                 }
 
                 if(nextInstr == 0xE500 && (std::string(overlayName) == "COMBAT-OV")) // >GAMEOPTIONS 
@@ -2964,17 +3115,17 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                     for(const auto& missile : missiles)
                     {
                         SF_Log("Missile %llu %f - CurrX: %d, CurrY: %d, DestX: %d, DestY: %d, Origin: %d, Class: %d, DeltaX: %d, DeltaY: %d\n",
-                               missile.nonce, (float)frameSync.completedFrames, missile.mr.currx, missile.mr.curry, missile.mr.destx, missile.mr.desty, missile.mr.morig, missile.mr.mclass, missile.mr.deltax, missile.mr.deltay);
+                               missile.nonce, (float)frameSync->completedFrames, missile.mr.currx, missile.mr.curry, missile.mr.destx, missile.mr.desty, missile.mr.morig, missile.mr.mclass, missile.mr.deltax, missile.mr.deltay);
                     }
 
                     s_missiles = missiles;
 
-                    frameSync.inCombatRender = false;
+                    frameSync->inCombatRender = false;
                 }
 
                 if (nextInstr == 0xa042) // .1LOGO
                 {
-                    frameSync.inSmallLogo = false;
+                    frameSync->inSmallLogo = false;
                 }
 
                 if (nextInstr == 0xF069) // WF069 AKA GET-MPS
@@ -3026,9 +3177,9 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
                 if(nextInstr == 0xe0a3 && (std::string(overlayName) == "HYPER-OV")) // .AUXSYS
                 {
-                    frameSync.inDrawAuxSys = false;
+                    frameSync->inDrawAuxSys = false;
 
-                    if (frameSync.gameContext == 2)
+                    if (frameSync->gameContext == 2)
                     {
 
                         uint32_t lo_iaddr = Read16(0x629f);
@@ -3372,7 +3523,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                     }
                     else
                     {
-                        if(frameSync.shouldSave)
+                        if(frameSync->shouldSave)
                         {
                             SF_Log("Failed to serialize state.\n");
                         }
@@ -3383,7 +3534,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                     }
                 };
 
-                if(frameSync.shouldSave)
+                if(frameSync->shouldSave)
                 {
                     serialized = Serialize(serializedRotoscope, serializedSnapshot, binHash, filename);
                 }
@@ -3496,12 +3647,15 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
         case 0x8A2D: // calculate memory offset for given coordinates. Interleaved. Maybe CGA?
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x25D7: // "KEY" read keyboard endless loop, executed by "0x17B7"
         {
+            // Waiting for input: whatever is drawn is what the player sees
+            GraphicsPublishFrame();
+
             uint16_t key = GraphicsGetKey();
             Push(key);
 
@@ -3524,13 +3678,15 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
         break;
 
         case 0x25bc: // "(?TERMINAL)" keyboard check buffer
+            // Screens that never flip (menus, text mode) poll here when idle
+            GraphicsPublishFrame();
 #if 0
-            if (frameSync.maneuvering && !frameSync.inGameOps)
+            if (frameSync->maneuvering && !frameSync->inGameOps)
             {
                 if (GraphicsHasKey())
                 {
-                    std::lock_guard<std::mutex> lg(frameSync.mutex);
-                    if (frameSync.gameTickTimer < 2)
+                    std::lock_guard<std::mutex> lg(frameSync->mutex);
+                    if (frameSync->gameTickTimer < 2)
                     {
                         Push(1);
                     }
@@ -3539,7 +3695,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                         Push(0);
                     }
 
-                    ++frameSync.gameTickTimer;
+                    ++frameSync->gameTickTimer;
                 }
                 else
                 {
@@ -3569,39 +3725,39 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
         case 0x175F: // read constant "LIT"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x1618: // read constant "2LIT"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
         case 0xC3A: // 2@
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
         case 0xC24: // 2!_2
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x30a8: // "ADVANCE>DEF"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x4D5C:  // Get segment:offset in array
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x4DA4: // "!OFFSET" sets 2D array pointers for faster access, like in C
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
@@ -3680,37 +3836,37 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
         case 0x14BD: // "DIGIT"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x22AB: // ENCLOSE
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
             break;
         }
 
         case 0x1AC0: // ???
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x718d: // "RECADD"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
             break;
 
         case 0x7295: // "BVSA>OFFBLK". Input: offset in file divided by 16, Prepare for "RECADD"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
             break;
 
         case 0x7684: // "PRIORITIZE"
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
 // 0x7684: pop    ax
@@ -3741,7 +3897,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 // 0x76b4: jmp    word ptr [bx]
 
         case 0x143A: // ">UPPERCASE"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
             break;
 
         case 0x2852: // "CUR>ADDR"
@@ -3757,17 +3913,17 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
           // 0x2721: sub    bh,bh
           // 0x2723: add    ax,bx
           // 0x2725: ret
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x2836: // ?POSITION
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
         case 0x0D35: // "FILL"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
@@ -3801,57 +3957,57 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
         case 0x11ED: // "U/MOD"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0xF4E: // "/"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0xF62: // "/MOD"
         {
-            Run8086(cs, addr, ds, cs, &regsp);        
+            ExecutePrimitive(addr);        
         }
         break;
 
         case 0x1261: // "="
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x127a: // "0<"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
         case 0x71DD: // "DOFFBLK" gets the idx from the dictionary in STARX.com
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x3672:
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
             break;
 
         case 0x4a15: // Helper for "CASE"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x3048: // "(BUFFER)"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
             case 0x2F51: // "LWSCAN"
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
 
@@ -3910,25 +4066,25 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
             break;
 
         case 0x36BB: // ???
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
             break;
 
 // ---------------------------------------------
 
         case 0x1248: // "<"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x122F: // ">"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x12a1: // "0>"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 // 0x12a1: pop    ax
 // 0x12a2: neg    ax
@@ -3941,13 +4097,13 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
         case 0x12E1: // "U<"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x11D8: // "U*"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
@@ -4001,13 +4157,13 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
         case 0x6D12: // "?UPDATE" converts addr to addr
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x4c87: // (SLIPPER)
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 // ---------------------------------------------
@@ -4018,10 +4174,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
             //std::this_thread::sleep_for(std::chrono::milliseconds(55));
 
             //PrintCallstacktrace(bx);
-            auto now = std::chrono::high_resolution_clock::now();
-
-            // Get the time since epoch in milliseconds
-            auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+            uint64_t millis = GetClockMilliseconds();
 
             Write16(0x18A, (uint16_t)(millis & 0xffff)); // TIME low
             Write16(0x188, (uint16_t)((millis >> 16) & 0xffff));   // TIME high
@@ -4064,7 +4217,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
         // --- graphics ---
         case 0x97cc: // COLORMAP. Determine color from given value. For example from landscape height
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 // 0x97cc: pop    bx
@@ -4098,6 +4251,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                 assert(destOffset == 0);
 
                 GraphicsCopyLine(srcSeg, destSeg, srcOffset, destOffset, 0x2000);
+                GraphicsPublishFrame(); // >DISPLAY page flips end here
             }
         break;
 
@@ -4121,7 +4275,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                 int color = Read16(0x55F2); // COLOR
 
                 // Write pixel data back to the buffer
-                if(frameSync.inDrawStarMap)
+                if(frameSync->inDrawStarMap)
                 {
                     GraphicsPixel(x, y, color & 0xf, Read16(0x5648), Rotoscope(StarMapPixel));
                 }
@@ -4154,12 +4308,12 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
             }
         break;
         case 0x93B1: // "BEXTENT" Part of Bit Block Image Transfer (BLT)
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
         case 0x9390: // "?EXTENTX"
            {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
            }
         break;
         case 0x902b: // "{BLT}" plot a bit pattern given parameters
@@ -4177,7 +4331,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
                 //SF_Log("blt xblt=%i yblt=%i lblt=%i wblt=%i color=%i 0x%04x:0x%04x 0x%04x xor %d\n", x0, y0, w, h, color, bltseg, bltoffs, bufseg, xormode);
                 Rotoscope rs{};
-                if (frameSync.inDrawStarMap)
+                if (frameSync->inDrawStarMap)
                 {
                     rs.content = StarMapPixel;
                 }
@@ -4186,11 +4340,11 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                     rs.content = PicPixel;
                 }
 
-                if(frameSync.inDrawShipButton)
+                if(frameSync->inDrawShipButton)
                 {
                     rs.picData.picID = 0x8000;
                 }
-                if(frameSync.inSmallLogo)
+                if(frameSync->inSmallLogo)
                 {
                     rs.picData.picID = 0x8001;
                 }
@@ -4211,7 +4365,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
         case 0x8891: // SCANPOLY
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
         break;
         case 0x90ad: // V>DISPLAY
@@ -4231,20 +4385,15 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                 int destinationX = destinationIndex % 40 + 3;
                 int destinationY = 199 - destinationIndex / 40;
 
-                for (int j = 0; j < 72; ++j) {
-                    Rotoscope rs;
-                    auto color = GraphicsPeek(sourceX + j, sourceY, sourceSegment, &rs);
-
-                    rs.content = NavigationalPixel;
-                    rs.blt_x = j;
-                    rs.blt_y = loopCounter - 1;
-                    rs.blt_w = 72;
-                    rs.blt_h = 120;
-                    GraphicsPixel(destinationX + j, destinationY, color, destinationSegment, rs);
-                }
+                Rotoscope rs(NavigationalPixel);
+                rs.blt_y = loopCounter - 1;
+                rs.blt_w = 72;
+                rs.blt_h = 120;
+                GraphicsCopyRect(sourceX, sourceY, 72, 1, destinationX, destinationY, sourceSegment, destinationSegment, &rs);
 
                 sourceIndex += 40;
             }
+            GraphicsPublishFrame();
         }
         break;
         case 0x9aba: // !IB
@@ -4263,7 +4412,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 // 0x9ac7: lodsw
 // 0x9ac8: mov    bx,ax
 // 0x9aca: jmp    word ptr [bx]
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x9a9e: // !IW
@@ -4283,12 +4432,12 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 // 0x9aad: lodsw
 // 0x9aae: mov    bx,ax
 // 0x9ab0: jmp    word ptr [bx]
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x9d18: // ?ILOCUS
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
 #if 0
             uint16_t locusCount = Read16(regsp);
 
@@ -4343,37 +4492,37 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
         break;
         case 0x9e14: // XCHGICON
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x9eb1: // ?IID
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x9a6c: // @IW
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x9a82: // @IH
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x4910: // 2^N
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x9970: // WLD>SCR
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x99b4: // SCR>BLT
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x9055: // LFILLPOLY 
@@ -4400,20 +4549,17 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                 auto xr = Read8(rasterOffset + 1);
                 //SF_Log("LFILLPOLY y %d, xl %d, xr %d color %d\n", y, xl, xr, color);
 
-                for(uint16_t x = xl; x <= xr; ++x)
+                if(frameSync->inDrawAuxSys)
                 {
-                    if(frameSync.inDrawAuxSys)
-                    {
-                        GraphicsPixel(x, y, color, bufseg, Rotoscope(AuxSysPixel));
-                    }
-                    else if(frameSync.inDrawStarMap)
-                    {
-                        GraphicsPixel(x, y, color, bufseg, Rotoscope(StarMapPixel));
-                    }
-                    else
-                    {
-                        GraphicsPixel(x, y, color, bufseg, Rotoscope(PolyFillPixel));
-                    }
+                    GraphicsFillSpan(y, xl, xr, color, bufseg, Rotoscope(AuxSysPixel));
+                }
+                else if(frameSync->inDrawStarMap)
+                {
+                    GraphicsFillSpan(y, xl, xr, color, bufseg, Rotoscope(StarMapPixel));
+                }
+                else
+                {
+                    GraphicsFillSpan(y, xl, xr, color, bufseg, Rotoscope(PolyFillPixel));
                 }
             }
         }
@@ -4433,44 +4579,14 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
                 auto bufseg = Read16(0x5648); // BUF-SEG
 
-                // At one point I had a purist interpretation here. I couldn't get it work
-                // and the flipped coordinate system was just confusing me and the AI.
-                // It's complicated because this is a in-graphics-memory move that should
-                // preserve overlapping areas. Ain't no one got time for that and I
-                // just allocate a temporary vector and copy the region there and
-                // back, making everyone's life easier.
-                std::vector<uint32_t> pixelData;
-                pixelData.resize(width * height);
-
-                std::vector<Rotoscope> rotoData;
-                rotoData.resize(width * height);
-
-                uint32_t pd = 0;
-                for(int y = 0; y < height; ++y)
-                {
-                    for(int x = 0; x < width; ++x)
-                    {
-                        pixelData[pd] = GraphicsPeekDirect(x + fulx, fuly - y, bufseg, &rotoData[pd]);
-
-                        ++pd;
-                    }
-                }
-
-                pd = 0;
-                for(int y = 0; y < height; ++y)
-                {
-                    for(int x = 0; x < width; ++x)
-                    {
-                        GraphicsPixelDirect(x + tulx, tuly - y, pixelData[pd], bufseg, rotoData[pd]);
-                        ++pd;
-                    }
-                }
+                // An in-graphics-memory move that has to preserve overlapping areas
+                GraphicsCopyRect(fulx, fuly, width, height, tulx, tuly, bufseg, bufseg);
             }
         break;
 
         case 0x6C86: // "C>EGA" 
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
@@ -4540,6 +4656,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
                     std::this_thread::yield();
                 }
 #endif
+                GraphicsPublishFrame();
             }
         break;
 
@@ -4642,17 +4759,17 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
         // move u from parm stack to the vector stack. Used as the Overlay call stack
         case 0x7AE7: // ">V"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
         // move u from vector stack to parm stack
         case 0x7AFE: // "V>"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
         // move u from vector stack to parm stack
         case 0x7B15: // "VI"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
         case 0x29FC: // "V!"
@@ -4714,8 +4831,8 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
             rc.content = RunBitPixel;
             rc.runBitData.tag = CurrentImageTagForHybridBlit;
             // Track last RunBit image tag for high-level status (logos, port-pic, etc.)
-            frameSync.lastRunBitTag = CurrentImageTagForHybridBlit;
-            SF_Log(".EGARUNBIT RunBit tag set to %u", static_cast<unsigned>(frameSync.lastRunBitTag));
+            frameSync->lastRunBitTag = CurrentImageTagForHybridBlit;
+            SF_Log(".EGARUNBIT RunBit tag set to %u", static_cast<unsigned>(frameSync->lastRunBitTag));
 
             // Update high-level state immediately after hybrid blit (Port-Pic, etc.)
             UpdateAndEmitStatus();
@@ -4739,7 +4856,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
             rc.blt_h = verticalLines;
 
-            static std::unordered_map<uint16_t, std::vector<uint32_t>> pixImages;
+            static thread_local std::unordered_map<uint16_t, std::vector<uint32_t>> pixImages;
 
             auto it = pixImages.find(CurrentImageTagForHybridBlit);
             if(it == pixImages.end())
@@ -4860,57 +4977,57 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
         // ---- 3 byte stack ---
         case 0x753F: // ">C"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
         case 0x755A: // "C>"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
         case 0x7577: // "CI"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
         case 0x75d7: // "CDEPTH"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
 // -------------------------------
 
         case 0x4997: // "1.5@"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
         case 0x49ae: // "1.5!_2"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
 // -------------------------------
 
         case 0x763a: // "@[IOFF]"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
         case 0x7425: // "IFLDADR"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 
 // ---------------------------------------------
 
         case 0x0D10: // "CMOVE"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x2EFE: // "LCMOVE"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x0D9C: //"ADDR>SEG"
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         break;
 // --------------------------
 
@@ -4931,19 +5048,19 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
         case 0x1593: // "(/LOOP)"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x155E: // "(+LOOP)"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x15D2: // "(LOOP)"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
@@ -4951,33 +5068,33 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
         case 0x1508:  // "S->D"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x1067: // "D+"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x10B9: // "DNEGATE"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x495E: // "D16*"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x4af3: // +BIT
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x4b08: // D2*
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
@@ -4985,7 +5102,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
         case 0x6f49: // "VA>BLK"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
             break;
         }
 
@@ -4995,71 +5112,71 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
         // -----------------------------------
 
-        case 0x0F22: Run8086(cs, addr, ds, cs, &regsp); break; // 0
-        case 0x0F30: Run8086(cs, addr, ds, cs, &regsp); break; // 1
-        case 0x0F3F: Run8086(cs, addr, ds, cs, &regsp); break; // 2
-        case 0x1340: Run8086(cs, addr, ds, cs, &regsp); break; // OR
-        case 0x12F7: Run8086(cs, addr, ds, cs, &regsp); break; // AND
-        case 0x1366: Run8086(cs, addr, ds, cs, &regsp); break; // XOR
-        case 0x0F74: Run8086(cs, addr, ds, cs, &regsp); break; // "+"
-        case 0x4bc5: Run8086(cs, addr, ds, cs, &regsp); break; // "+-@" sign extend
-        case 0x0F94: Run8086(cs, addr, ds, cs, &regsp); break; // "-"
-        case 0x0FB5: Run8086(cs, addr, ds, cs, &regsp); break; // *
-        case 0x11C8: Run8086(cs, addr, ds, cs, &regsp); break; // NEGATE
-        case 0x1309: Run8086(cs, addr, ds, cs, &regsp); break;// "NOT"
-        case 0x128B: Run8086(cs, addr, ds, cs, &regsp); break; // "0="
-        case 0x1007: Run8086(cs, addr, ds, cs, &regsp); break; // 2*
-        case 0x4984: Run8086(cs, addr, ds, cs, &regsp); break; // "3+"
-        case 0x0FE9: Run8086(cs, addr, ds, cs, &regsp); break; // "1+"
-        case 0x0FF8: Run8086(cs, addr, ds, cs, &regsp); break; // "1-"
-        case 0x1017: Run8086(cs, addr, ds, cs, &regsp); break; // "2+"
-        case 0x1027: Run8086(cs, addr, ds, cs, &regsp); break; // "2-"
-        case 0x4935: Run8086(cs, addr, ds, cs, &regsp); break; // 16/
-        case 0x1037: Run8086(cs, addr, ds, cs, &regsp); break; // "2/"
-        case 0x4949: Run8086(cs, addr, ds, cs, &regsp); break; // "16*"
+        case 0x0F22: ExecutePrimitive(addr); break; // 0
+        case 0x0F30: ExecutePrimitive(addr); break; // 1
+        case 0x0F3F: ExecutePrimitive(addr); break; // 2
+        case 0x1340: ExecutePrimitive(addr); break; // OR
+        case 0x12F7: ExecutePrimitive(addr); break; // AND
+        case 0x1366: ExecutePrimitive(addr); break; // XOR
+        case 0x0F74: ExecutePrimitive(addr); break; // "+"
+        case 0x4bc5: ExecutePrimitive(addr); break; // "+-@" sign extend
+        case 0x0F94: ExecutePrimitive(addr); break; // "-"
+        case 0x0FB5: ExecutePrimitive(addr); break; // *
+        case 0x11C8: ExecutePrimitive(addr); break; // NEGATE
+        case 0x1309: ExecutePrimitive(addr); break;// "NOT"
+        case 0x128B: ExecutePrimitive(addr); break; // "0="
+        case 0x1007: ExecutePrimitive(addr); break; // 2*
+        case 0x4984: ExecutePrimitive(addr); break; // "3+"
+        case 0x0FE9: ExecutePrimitive(addr); break; // "1+"
+        case 0x0FF8: ExecutePrimitive(addr); break; // "1-"
+        case 0x1017: ExecutePrimitive(addr); break; // "2+"
+        case 0x1027: ExecutePrimitive(addr); break; // "2-"
+        case 0x4935: ExecutePrimitive(addr); break; // 16/
+        case 0x1037: ExecutePrimitive(addr); break; // "2/"
+        case 0x4949: ExecutePrimitive(addr); break; // "16*"
         case 0x1355:  // "TOGGLE"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         // ----- memory operations -----
 
-        case 0x0BB0: Run8086(cs, addr, ds, cs, &regsp); break; // "@"
-        case 0x0C94: Run8086(cs, addr, ds, cs, &regsp); break; // "C@"
-        case 0x0BE1: Run8086(cs, addr, ds, cs, &regsp); break; // "!", "<!>"
-        case 0x0C60: Run8086(cs, addr, ds, cs, &regsp); break; // "C!"
+        case 0x0BB0: ExecutePrimitive(addr); break; // "@"
+        case 0x0C94: ExecutePrimitive(addr); break; // "C@"
+        case 0x0BE1: ExecutePrimitive(addr); break; // "!", "<!>"
+        case 0x0C60: ExecutePrimitive(addr); break; // "C!"
 
         case 0x2EB8: // "L!"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x2EA4: // "L@"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x2EE5: // "LC!"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x2eCD: // "LC@"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x49f0: // 'L+-@'
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
         case 0x0F85:  // "+!"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
@@ -5072,17 +5189,17 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
         case 0x0DCA: if (Read16(regsp) != 0) Push(Read16(regsp)); break; //"?DUP"
         case 0x0EF4: // "SWAP"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x0E08: // "2SWAP"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x0EB5: // "ROT"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
@@ -5099,14 +5216,14 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
         case 0x0D7C: Push((Pop()-cs)<<4); break; // "SEG>ADDR"
         case 0x4abb: // FRND
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
         case 0x4892: break; // "CAPSON" Turn on caps
 
         case 0x6cd6: // E>CGA
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
@@ -5121,7 +5238,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 
         case 0x4b17: // EASY-BITS for SQRT
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
@@ -5197,7 +5314,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
         break;
         case 0x992d: // "?INVIS"
         {
-            Run8086(cs, addr, ds, cs, &regsp);
+            ExecutePrimitive(addr);
         }
         break;
 
@@ -5214,32 +5331,32 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
             break;
         case 0xeadc: // WEADC
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
         case 0xeaea: // WEAEA
             {
-                Run8086(cs, addr, ds, cs, &regsp);            
+                ExecutePrimitive(addr);            
             }
             break;
         case 0xeaf8: // WEAF8
             {
-                Run8086(cs, addr, ds, cs, &regsp);            
+                ExecutePrimitive(addr);            
             }
             break; // +TMP
         case 0xed34:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
         case 0xed44: // -TMP
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
         case 0xed50: // @TMP
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
 // ================================================
@@ -5256,7 +5373,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 // 0xed71: jmp    word ptr [bx]
         case 0xed62:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
 // 0xee65: mov    cx,es
@@ -5281,7 +5398,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 // 0xee8d: mov    es,cx       
         case 0xee65: // PUSH-POLY
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
 // 0xeee5: xor    ax,ax
@@ -5293,7 +5410,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 // 0xeef2: push   ax
         case 0xeee5:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }  
             break;
 // 0xee98: mov    dx,[52A2] // POLYSEG
@@ -5312,7 +5429,7 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 // 0xeeb5: mov    [ED7D],bx // FADDR
         case 0xee96:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }   
             break;   
 // 0xeecc: xor    ax,ax
@@ -5326,55 +5443,55 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
 // 0xeedd: push   ax
         case 0xeecc:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;       
 // 0xeec2: add    sp,06
         case 0xeec2:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
         case 0xdf13:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }   
             break;
         case 0xe1b6:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
         case 0xe228:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
 // 0xdf02: mov    [DC20],sp // WDC20            
         case 0xdf02:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
         case 0xdd2c:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
          
         case 0xe48c:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
         case 0xe4aa:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
         case 0x9841: // BUFFERXY
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
         case 0x9097: // SQLPLOT - square plot, used for the fracal maps
@@ -5419,12 +5536,12 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
             break;
         case 0xe16b:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;            
         case 0x1047:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
         case 0x9081:
@@ -5457,22 +5574,22 @@ enum RETURNCODE Call(unsigned short addr, unsigned short bx)
             break;
         case 0xefd9: // CBLTP -- MAPS-OV
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
         case 0xe8f3:// CBLTP -- MOVE-OV
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
         case 0x48dc:
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
         case 0x8783: // CLIPPER
             {
-                Run8086(cs, addr, ds, cs, &regsp);
+                ExecutePrimitive(addr);
             }
             break;
         default:
@@ -5511,9 +5628,10 @@ void LoadSTARFLT(std::filesystem::path path)
     FILE *fp;
     int ret;
 
-    char cwd[1024];
-    if (_getcwd(cwd, sizeof(cwd)) != NULL) {
-        SF_Log( "LoadSTARFLT: cwd = %s\n", cwd);
+    std::error_code cwdError;
+    std::filesystem::path cwd = std::filesystem::current_path(cwdError);
+    if (!cwdError) {
+        SF_Log( "LoadSTARFLT: cwd = %s\n", cwd.string().c_str());
     } else {
         SF_Log( "LoadSTARFLT: getcwd failed\n");
     }
@@ -5547,7 +5665,8 @@ void LoadSTARFLT(std::filesystem::path path)
         UE_LOG(LogStarflightEmulator, Fatal, TEXT("Cannot open file %s"), UTF8_TO_TCHAR(staraPath.c_str()));
         return; // Fatal will terminate
     }
-    ret = fread(STARA_ORIG, 256000, 1, fp);
+    EmulatorContext& context = EmulatorContext::Current();
+    ret = fread(context.staraOrig.data(), context.staraOrig.size(), 1, fp);
     fclose(fp);
 
     fp = fopen(starbPath.c_str(), "rb");
@@ -5556,13 +5675,13 @@ void LoadSTARFLT(std::filesystem::path path)
         UE_LOG(LogStarflightEmulator, Fatal, TEXT("Cannot open file %s"), UTF8_TO_TCHAR(starbPath.c_str()));
         return; // Fatal will terminate
     }
-    ret = fread(STARB_ORIG, 362496, 1, fp);
+    ret = fread(context.starbOrig.data(), context.starbOrig.size(), 1, fp);
     fclose(fp);
 
     if(path.empty())
     {
-        memcpy(STARA, STARA_ORIG, sizeof(STARA));
-        memcpy(STARB, STARB_ORIG, sizeof(STARB));
+        context.stara = context.staraOrig;
+        context.starb = context.starbOrig;
     }
     else
     {
@@ -5588,7 +5707,7 @@ enum RETURNCODE Step()
 
     if (debuglevel)
     {
-      int ovidx = GetOverlayIndex(Read16(0x55a5), nullptr);
+      int ovidx = GetCurrentOverlayIndex();
       SF_Log("si=0x%04x exec=0x%04x word=0x%04x sp=0x%04x ov=%2i", regsi-2, execaddr, bx+2, regsp, ovidx);
       SF_Log(" %s\n", FindWord(bx+2, -1));
     }
@@ -5609,7 +5728,7 @@ enum RETURNCODE Step()
 
     // Compute high-level state and publish to Unreal when it changes
     {
-        static FStarflightEmulatorState s_lastState = FStarflightEmulatorState::Unknown;
+        static thread_local FStarflightEmulatorState s_lastState = FStarflightEmulatorState::Unknown;
         FStarflightEmulatorState newState = ComputeHighLevelState();
         if (newState != s_lastState)
         {
@@ -5617,8 +5736,8 @@ enum RETURNCODE Step()
 
             FStarflightStatus status;
             status.State = newState;
-            status.GameContext = frameSync.gameContext;
-            status.LastRunBitTag = static_cast<uint16_t>(frameSync.lastRunBitTag);
+            status.GameContext = frameSync->gameContext;
+            status.LastRunBitTag = static_cast<uint16_t>(frameSync->lastRunBitTag);
 
             EmitStatus(status);
 
@@ -5634,12 +5753,14 @@ enum RETURNCODE Step()
 
 void InitEmulator(std::filesystem::path path)
 {
-    // Ensure a fresh trace file each run
-    {
-        std::error_code ec;
-        std::filesystem::remove("c:/temp/call_trace.txt", ec);
-    }
-    
+    // Hosts may call InitCPU() on one thread and run the emulator on another, so bind
+    // this thread to its context (or the default one) before mem/m are touched
+    EmulatorContext::Current();
+
+    std::call_once(s_wordHandlersOnce, RegisterWordHandlers);
+
+    // Registers are per thread, so set them on the thread that runs Step()
+    regsi = 0x129;
     regbp = 0xd4a7 + 0x100 + 0x80; // call stack
     regsp = 0xd4a7 + 0x100;  // initial parameter stack
     LoadSTARFLT(path);
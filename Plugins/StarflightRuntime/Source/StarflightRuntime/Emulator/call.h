@@ -4,6 +4,7 @@
 #include <string>
 #include <functional>
 #include <filesystem>
+#include <cstdint>
 
 enum RETURNCODE {OK, EMULATOR_ERROR, EXIT, CHARINPUT, STOP};
 
@@ -14,6 +15,15 @@ void SaveSTARFLT();
 void EnableDebug();
 void PrintCStack();
 
+// Runs the XABS/YABS log and word tracking for every word
+void EnableCallInstrumentation(bool enable);
+uint64_t GetWordsExecuted();
+uint64_t GetWordsPerSecond();
+
+// Derives "TIME" from the word counter instead of the wall clock, 0 = wall clock
+void SetVirtualClock(uint32_t wordsPerMillisecond);
+uint64_t GetClockMilliseconds();
+
 void FillKeyboardBufferString(const char *str);
 void FillKeyboardBufferKey(unsigned short key);
 
@@ -5,6 +5,8 @@
 #include <cmath>
 #include <vector>
 
+#include "framesync.h"
+
 // Stubs for missing dependencies in call.cpp
 
 // Diligent graphics engine stubs
@@ -45,17 +47,14 @@ enum PixelContents {
     SpaceManPixel,
 };
 
-// Tagged data structure to replace std::vector with .tag member
+// Run-bit image tag / pic ID of the primitive that drew a pixel
 struct TaggedData {
-    std::vector<uint8_t> data;
     uint32_t tag = 0;
     uint32_t picID = 0;
-    
-    // Allow implicit conversion to vector for compatibility
-    operator std::vector<uint8_t>&() { return data; }
-    operator const std::vector<uint8_t>&() const { return data; }
 };
 
+// Describes what a pixel belongs to. Passed to the Graphics* calls by reference;
+// graphics.cpp keeps it per pixel in packed planes, not as this struct.
 struct Rotoscope {
     PixelContents content;
     uint8_t EGAcolor;
@@ -67,48 +66,10 @@ struct Rotoscope {
     TaggedData runBitData;
     TaggedData picData;
     
-    Rotoscope() : content(ClearPixel), EGAcolor(0), argb(0), blt_x(0), blt_y(0), blt_w(0), blt_h(0), bgColor(0), fgColor(0) {}
-    Rotoscope(PixelContents pc) : content(pc), EGAcolor(0), argb(0), blt_x(0), blt_y(0), blt_w(0), blt_h(0), bgColor(0), fgColor(0) {}
-};
-
-enum class OrbitState {
-    None,
-    Insertion,
-    Landing,
-    Takeoff,
-    Holding,
-    Orbit
+    Rotoscope() : content(ClearPixel), EGAcolor(0), argb(0), blt_x(0), blt_y(0), blt_w(0), blt_h(0), bgColor(0), fgColor(0), lineData{}, textData{} {}
+    Rotoscope(PixelContents pc) : content(pc), EGAcolor(0), argb(0), blt_x(0), blt_y(0), blt_w(0), blt_h(0), bgColor(0), fgColor(0), lineData{}, textData{} {}
 };
 
-struct FrameSync {
-    bool inDrawAuxSys = false;
-    bool inDrawStarMap = false;
-    bool maneuvering = false;
-    uint32_t gameContext = 0;
-    bool shouldSave = false;
-    bool inCombatKey = false;
-    bool inCombatRender = false;
-    bool inDrawShipButton = false;
-    bool inSmallLogo = false;
-    float currentPlanetMass = 0.0f;
-    float currentPlanetSphereSize = 0.0f;
-    bool pastHimus = false;
-    bool inGameOps = false;
-    bool inNebula = false;
-    bool inFlux = false;
-    uint32_t currentPlanet = 0;
-    uint32_t completedFrames = 0;
-    // Last RunBitPixel tag seen (from CSCR>EGA or .EGARUNBIT paths)
-    uint16_t lastRunBitTag = 0;
-    OrbitState currentOrbitState = OrbitState::None;
-    std::chrono::steady_clock::time_point maneuveringStartTime;
-    std::chrono::steady_clock::time_point maneuveringEndTime;
-    int32_t gameTickTimer;
-    std::mutex mutex;
-};
-
-extern FrameSync frameSync;
-
 // Archive structures
 struct SectionHeader {
     uint64_t offset;
@@ -256,7 +217,7 @@ inline void GraphicsSaveScreen() {}
 inline void GraphicsSetDeadReckoning(int16_t x, int16_t y, const std::vector<Icon>&, const std::vector<Icon>&, uint16_t, const StarMapSetup&, const std::vector<MissileRecordUnique>&, const std::vector<LaserRecord>&, const std::vector<Explosion>&) {}
 inline void GraphicsSetOrbitState(OrbitState state, vec3<float> sunPos = vec3<float>())
 {
-    frameSync.currentOrbitState = state;
+    frameSync->currentOrbitState = state;
 }
 inline void GraphicsInitPlanets(const std::vector<std::vector<uint8_t>>&) {}
 inline void GraphicsInitPlanets(const std::unordered_map<uint32_t, struct PlanetSurface>&) {}
@@ -265,4 +226,4 @@ inline void GraphicsReportGameFrame() {}
 inline void GraphicsSplash(uint32_t ds, int fileNum) {}
 void GraphicsMoveSpaceMan(uint16_t x, uint16_t y);
 uint32_t GraphicsPeekDirect(int x, int y, uint32_t offset, Rotoscope* rs = nullptr);
-void GraphicsPixelDirect(int x, int y, uint32_t color, uint32_t offset, Rotoscope rs = Rotoscope());
+void GraphicsPixelDirect(int x, int y, uint32_t color, uint32_t offset, const Rotoscope& rs = Rotoscope());
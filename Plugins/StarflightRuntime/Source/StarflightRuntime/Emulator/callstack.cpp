@@ -4,46 +4,41 @@
 
 #include"findword.h"
 #include"cpu/cpu.h"
+#include"context.h"
 
 // Wrapper macros for memory access
-extern unsigned char* currentMemory;
+extern thread_local unsigned char* currentMemory;
 
 // ------------------------------------------------
 // Functions to print the call stack properly
 // ------------------------------------------------
 
-unsigned short int bpbase = 0;
-
-void SetBPBase(int bp)
+// The call stack moves to a second base once the game has set it up
+static unsigned short int CallStackBase()
 {
     const unsigned short int bpbase1 = 0xd4a7 + 0x100 + 0x80; // early call stack base
     const unsigned short int bpbase2 = 0xd4a7 + 0x100 + 0x80+8615; // late call stack base
 
-    bpbase = bpbase1;
-    if (regbp > bpbase)
-    {
-        bpbase = bpbase2;
-    }
+    return regbp > bpbase1 ? bpbase2 : bpbase1;
 }
 
-int iscall[20000];
-int iscallovidx[20000];
-
 void DefineCallStack(int bp, int value)
 {
-    SetBPBase(bp);
+    EmulatorContext& context = EmulatorContext::Current();
+    const unsigned short int bpbase = CallStackBase();
     //printf("%i\n", bpbase-bp);
     if (bpbase-bp > 0)
     {
-        iscall[(bpbase-bp)>>1] = value;
-        if (value) iscallovidx[(bpbase-bp)>>1] = GetOverlayIndex(Read16(0x55a5), NULL);
+        context.callStackIsCall[(bpbase-bp)>>1] = value;
+        if (value) context.callStackOverlay[(bpbase-bp)>>1] = GetCurrentOverlayIndex();
     }
 }
 
 void PrintCallstacktrace(int bx)
 {
-    int ovidx = GetOverlayIndex(Read16(0x55a5), NULL);
-    SetBPBase(regbp);
+    EmulatorContext& context = EmulatorContext::Current();
+    int ovidx = GetCurrentOverlayIndex();
+    const unsigned short int bpbase = CallStackBase();
     printf("========================================\n");
     printf("              Callstack\n");
     printf("  Address         Overlay   Word \n");
@@ -54,9 +49,9 @@ void PrintCallstacktrace(int bx)
     printf("  0x%04x  %15s   %s\n", word, GetOverlayName(word, ovidx), FindWord(word, ovidx));
     for(int i=regbp; i<bpbase; i += 2)
     {
-        if (iscall[(bpbase-i)>>1])
+        if (context.callStackIsCall[(bpbase-i)>>1])
         {
-            ovidx = iscallovidx[(bpbase-i)>>1];
+            ovidx = context.callStackOverlay[(bpbase-i)>>1];
             int word_inner = FindClosestWord(Read16(i), ovidx);
             const char* ovname = GetOverlayName(word_inner, ovidx);
             printf("  0x%04x  %15s   %s\n", word_inner, ovname, FindWord(word_inner, ovidx));
@@ -0,0 +1,196 @@
+#pragma warning(disable: 4996) // CRT security warnings
+
+#include "calltrace.h"
+
+#include <stdio.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Unreal Engine logging
+#include <stdarg.h>
+#include "Logging/LogMacros.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogStarflightCallTrace, Log, All);
+
+// Simple wrapper to redirect printf-style logging to UE
+static void SF_Log(const char* Format, ...)
+{
+	static thread_local char Buffer[4096];
+	va_list Args;
+	va_start(Args, Format);
+	vsnprintf(Buffer, sizeof(Buffer), Format, Args);
+	va_end(Args);
+	UE_LOG(LogStarflightCallTrace, Log, TEXT("%s"), ANSI_TO_TCHAR(Buffer));
+}
+
+std::atomic<bool> g_callTraceEnabled{false};
+
+// Single producer (the owning thread), single consumer (the flusher)
+struct CallTraceRing
+{
+    static constexpr uint32_t Size = 1 << 16;
+
+    CallTraceRecord records[Size];
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> tail{0};
+    std::atomic<uint32_t> dropped{0};
+    uint32_t threadId = 0;
+};
+
+static std::mutex s_ringsMutex;
+static std::vector<CallTraceRing*> s_rings; // never freed, there are only a few emulator threads
+static thread_local CallTraceRing* s_threadRing = nullptr;
+
+static std::chrono::steady_clock::time_point s_traceStart;
+static std::filesystem::path s_tracePath;
+static FILE* s_traceFile = nullptr;
+
+static std::thread s_flushThread;
+static std::mutex s_flushMutex;
+static std::condition_variable s_flushSignal;
+static bool s_flushStop = false;
+
+static CallTraceRing* RegisterThreadRing()
+{
+    std::lock_guard<std::mutex> lock(s_ringsMutex);
+    CallTraceRing* ring = new CallTraceRing();
+    ring->threadId = (uint32_t)s_rings.size();
+    s_rings.push_back(ring);
+    return ring;
+}
+
+void CallTraceWrite(uint16_t si, uint16_t ov, uint16_t addr, uint16_t bx)
+{
+    if (s_threadRing == nullptr)
+        s_threadRing = RegisterThreadRing();
+
+    CallTraceRing* ring = s_threadRing;
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= CallTraceRing::Size)
+    {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto tick = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_traceStart).count();
+    ring->records[head & (CallTraceRing::Size - 1)] = { si, ov, addr, bx, (uint32_t)tick };
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+static void DrainRing(CallTraceRing* ring, std::vector<CallTraceRecord>& records, std::vector<uint8_t>& encoded)
+{
+    uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint32_t head = ring->head.load(std::memory_order_acquire);
+    if (head == tail)
+        return;
+
+    records.clear();
+    for (uint32_t i = tail; i != head; i++)
+    {
+        records.push_back(ring->records[i & (CallTraceRing::Size - 1)]);
+    }
+    ring->tail.store(head, std::memory_order_release);
+
+    encoded.resize(records.size() * CallTraceMaxEncodedRecordSize);
+    CallTraceChunkHeader chunk{};
+    chunk.threadId = ring->threadId;
+    chunk.recordCount = (uint32_t)records.size();
+    chunk.droppedCount = ring->dropped.exchange(0, std::memory_order_relaxed);
+    chunk.encodedSize = (uint32_t)CallTraceEncode(records.data(), records.size(), encoded.data());
+
+    fwrite(&chunk, sizeof(chunk), 1, s_traceFile);
+    fwrite(encoded.data(), 1, chunk.encodedSize, s_traceFile);
+}
+
+static void DrainAllRings(std::vector<CallTraceRecord>& records, std::vector<uint8_t>& encoded)
+{
+    std::vector<CallTraceRing*> rings;
+    {
+        std::lock_guard<std::mutex> lock(s_ringsMutex);
+        rings = s_rings;
+    }
+
+    for (CallTraceRing* ring : rings)
+    {
+        DrainRing(ring, records, encoded);
+    }
+    fflush(s_traceFile);
+}
+
+static void FlushThread()
+{
+    std::vector<CallTraceRecord> records;
+    std::vector<uint8_t> encoded;
+    records.reserve(CallTraceRing::Size);
+
+    std::unique_lock<std::mutex> lock(s_flushMutex);
+    while (!s_flushStop)
+    {
+        s_flushSignal.wait_for(lock, std::chrono::milliseconds(50));
+        DrainAllRings(records, encoded);
+    }
+}
+
+void SetCallTracePath(const std::filesystem::path& path)
+{
+    s_tracePath = path;
+}
+
+void EnableCallTrace(bool enable)
+{
+    if (enable == IsCallTraceEnabled())
+        return;
+
+    if (!enable)
+    {
+        g_callTraceEnabled.store(false, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(s_flushMutex);
+            s_flushStop = true;
+        }
+        s_flushSignal.notify_one();
+        if (s_flushThread.joinable()) s_flushThread.join();
+
+        fclose(s_traceFile);
+        s_traceFile = nullptr;
+        SF_Log("Call trace closed\n");
+        return;
+    }
+
+    if (s_tracePath.empty())
+    {
+        std::error_code ec;
+        s_tracePath = std::filesystem::temp_directory_path(ec) / "starflight_call_trace.sfct";
+    }
+
+    s_traceFile = fopen(s_tracePath.string().c_str(), "wb");
+    if (s_traceFile == nullptr)
+    {
+        SF_Log("Cannot open call trace file %s\n", s_tracePath.string().c_str());
+        return;
+    }
+
+    CallTraceFileHeader header{ CallTraceMagic, CallTraceVersion };
+    fwrite(&header, sizeof(header), 1, s_traceFile);
+
+    // Discard whatever was left over from a previous session
+    {
+        std::lock_guard<std::mutex> lock(s_ringsMutex);
+        for (CallTraceRing* ring : s_rings)
+        {
+            ring->tail.store(ring->head.load(std::memory_order_acquire), std::memory_order_release);
+            ring->dropped.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    s_traceStart = std::chrono::steady_clock::now();
+    s_flushStop = false;
+    s_flushThread = std::thread(FlushThread);
+    g_callTraceEnabled.store(true, std::memory_order_relaxed);
+
+    SF_Log("Call trace enabled, writing to %s\n", s_tracePath.string().c_str());
+}
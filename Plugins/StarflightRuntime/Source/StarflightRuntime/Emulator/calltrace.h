@@ -0,0 +1,138 @@
+#ifndef CALLTRACE_H
+#define CALLTRACE_H
+
+#include <stdint.h>
+#include <atomic>
+#include <filesystem>
+
+// ------------------------------------------------
+// Binary call trace
+//
+// Every traced Call() appends a fixed-size record to a per-thread ring
+// buffer. A background thread drains the rings and writes delta encoded
+// chunks to disk. Use the sftrace tool to turn a trace file back into text.
+// ------------------------------------------------
+
+struct CallTraceRecord
+{
+    uint16_t si;    // Forth instruction pointer
+    uint16_t ov;    // overlay segment from "OV#"
+    uint16_t addr;  // code field address
+    uint16_t bx;    // word address - 2
+    uint32_t tick;  // microseconds since tracing was enabled
+};
+
+// File layout: CallTraceFileHeader followed by chunks. Every chunk is a
+// CallTraceChunkHeader followed by encodedSize bytes. Each record is stored
+// as five zigzag varints, the differences of si, ov, addr, bx and tick to
+// the previous record of the same chunk.
+constexpr uint32_t CallTraceMagic = 0x54434653; // "SFCT"
+constexpr uint32_t CallTraceVersion = 1;
+
+struct CallTraceFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+};
+
+struct CallTraceChunkHeader
+{
+    uint32_t threadId;
+    uint32_t recordCount;
+    uint32_t droppedCount; // records lost because the ring was full
+    uint32_t encodedSize;
+};
+
+extern std::atomic<bool> g_callTraceEnabled;
+
+inline bool IsCallTraceEnabled()
+{
+    return g_callTraceEnabled.load(std::memory_order_relaxed);
+}
+
+// Output file used the next time tracing is enabled
+void SetCallTracePath(const std::filesystem::path& path);
+void EnableCallTrace(bool enable);
+
+void CallTraceWrite(uint16_t si, uint16_t ov, uint16_t addr, uint16_t bx);
+
+// ------------------------------------------------
+// Chunk encoding, shared with the decoder
+// ------------------------------------------------
+
+constexpr size_t CallTraceMaxEncodedRecordSize = 3 * 4 + 5;
+
+inline uint8_t* CallTracePutVarint(uint8_t* out, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (uint8_t)value;
+    return out;
+}
+
+inline const uint8_t* CallTraceGetVarint(const uint8_t* in, const uint8_t* end, uint32_t* value)
+{
+    uint32_t result = 0;
+    for (int shift = 0; in < end && shift < 35; shift += 7)
+    {
+        uint8_t b = *in++;
+        result |= (uint32_t)(b & 0x7f) << shift;
+        if ((b & 0x80) == 0)
+        {
+            *value = result;
+            return in;
+        }
+    }
+    return nullptr;
+}
+
+inline uint32_t CallTraceZigZag(int32_t value) { return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31); }
+inline int32_t CallTraceUnZigZag(uint32_t value) { return (int32_t)(value >> 1) ^ -(int32_t)(value & 1); }
+
+// out must hold count * CallTraceMaxEncodedRecordSize bytes
+inline size_t CallTraceEncode(const CallTraceRecord* records, size_t count, uint8_t* out)
+{
+    uint8_t* start = out;
+    CallTraceRecord prev{};
+    for (size_t i = 0; i < count; i++)
+    {
+        const CallTraceRecord& r = records[i];
+        out = CallTracePutVarint(out, CallTraceZigZag((int16_t)(r.si - prev.si)));
+        out = CallTracePutVarint(out, CallTraceZigZag((int16_t)(r.ov - prev.ov)));
+        out = CallTracePutVarint(out, CallTraceZigZag((int16_t)(r.addr - prev.addr)));
+        out = CallTracePutVarint(out, CallTraceZigZag((int16_t)(r.bx - prev.bx)));
+        out = CallTracePutVarint(out, CallTraceZigZag((int32_t)(r.tick - prev.tick)));
+        prev = r;
+    }
+    return out - start;
+}
+
+// Returns the number of decoded records, or 0 on malformed input
+inline size_t CallTraceDecode(const uint8_t* in, size_t size, CallTraceRecord* records, size_t count)
+{
+    const uint8_t* end = in + size;
+    CallTraceRecord prev{};
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t v[5];
+        for (int j = 0; j < 5; j++)
+        {
+            in = CallTraceGetVarint(in, end, &v[j]);
+            if (in == nullptr)
+                return 0;
+        }
+        CallTraceRecord& r = records[i];
+        r.si = (uint16_t)(prev.si + CallTraceUnZigZag(v[0]));
+        r.ov = (uint16_t)(prev.ov + CallTraceUnZigZag(v[1]));
+        r.addr = (uint16_t)(prev.addr + CallTraceUnZigZag(v[2]));
+        r.bx = (uint16_t)(prev.bx + CallTraceUnZigZag(v[3]));
+        r.tick = prev.tick + (uint32_t)CallTraceUnZigZag(v[4]);
+        prev = r;
+    }
+    return count;
+}
+
+#endif
@@ -0,0 +1,64 @@
+#include "context.h"
+#include "cpu/cpu.h"
+#include "graphics.h"
+
+#include <new>
+#include <string.h>
+
+static constexpr std::align_val_t MemoryAlignment{4096};
+
+void EmulatorContext::AlignedDelete::operator()(uint8_t* p) const
+{
+    ::operator delete[](p, MemoryAlignment);
+}
+
+EmulatorContext::EmulatorContext()
+    : memory(static_cast<uint8_t*>(::operator new[](SystemMemorySize, MemoryAlignment)))
+    , ioPorts(new uint8_t[0x10000]())
+    , callStackIsCall(CallStackSlots)
+    , callStackOverlay(CallStackSlots)
+    , stara(StarASize)
+    , staraOrig(StarASize)
+    , starb(StarBSize)
+    , starbOrig(StarBSize)
+    , graphics(GraphicsCreateState())
+{
+    memset(memory.get(), 0, SystemMemorySize);
+}
+
+EmulatorContext::~EmulatorContext()
+{
+    if (s_current == this)
+    {
+        s_current = nullptr;
+        ::frameSync = nullptr;
+    }
+    GraphicsDestroyState(graphics);
+}
+
+void EmulatorContext::MakeCurrent()
+{
+    if (s_current != this)
+    {
+        if (s_current)
+        {
+            s_current->forthRegisters = { regsp, regbp, regsi, regbx };
+        }
+        regsp = forthRegisters.sp;
+        regbp = forthRegisters.bp;
+        regsi = forthRegisters.si;
+        regbx = forthRegisters.bx;
+    }
+
+    s_current = this;
+    ::frameSync = &frameSync;
+    BindCPU(memory.get());
+    Bind8086(memory.get(), ioPorts.get(), biosTables, &cpu8086);
+}
+
+EmulatorContext& EmulatorContext::BindDefault()
+{
+    static EmulatorContext s_default;
+    s_default.MakeCurrent();
+    return s_default;
+}
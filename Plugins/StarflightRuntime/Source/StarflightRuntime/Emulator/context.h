@@ -0,0 +1,86 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "cpu/cpu8086state.h"
+#include "framesync.h"
+
+struct GraphicsState;
+
+constexpr size_t StarASize = 256000;
+constexpr size_t StarBSize = 362496;
+constexpr size_t CallStackSlots = 20000;
+
+// ------------------------------------------------
+// Emulator context
+//
+// One emulated machine: the 8086 address space, the STARA/STARB disk images,
+// the graphics planes and key queue, and the word counter and clock. The
+// emulator reaches it through EmulatorContext::Current(), which is bound per
+// thread. A thread that never called MakeCurrent() gets the process default
+// context, so single-instance hosts need not know about contexts at all.
+//
+// The 8086 register file, the frame-sync state and the call stack markers are
+// members too. The Forth registers belong to the context as well, but the
+// emulator works on thread_local copies (regsp etc. in cpu.cpp) for speed;
+// MakeCurrent() stores them back when a thread switches to another context.
+// Decoder scratch, word-local temporaries and the game-flow caches in call.cpp
+// stay thread_local: a context runs on one emulator thread, and every thread
+// that touches it (presenter, input) binds it with MakeCurrent() first.
+// ------------------------------------------------
+
+class EmulatorContext
+{
+public:
+    EmulatorContext();
+    ~EmulatorContext();
+
+    EmulatorContext(const EmulatorContext&) = delete;
+    EmulatorContext& operator=(const EmulatorContext&) = delete;
+
+    void MakeCurrent();
+
+    static EmulatorContext& Current()
+    {
+        return s_current ? *s_current : BindDefault();
+    }
+
+    struct AlignedDelete { void operator()(uint8_t* p) const; };
+
+    std::unique_ptr<uint8_t[], AlignedDelete> memory; // SystemMemorySize bytes, page aligned
+    std::unique_ptr<uint8_t[]> ioPorts;               // 0x10000 bytes
+    uint8_t biosTables[20][256] = {};
+    Cpu8086State cpu8086 = {};
+    FrameSync frameSync;
+
+    // regsp, regbp, regsi and regbx while another context is bound
+    struct ForthRegisters { uint16_t sp = 0, bp = 0, si = 0, bx = 0; } forthRegisters;
+
+    // Marks which call stack slots hold a return address, and its overlay, see callstack.cpp
+    std::vector<int> callStackIsCall;
+    std::vector<int> callStackOverlay;
+
+    std::vector<uint8_t> stara;
+    std::vector<uint8_t> staraOrig;
+    std::vector<uint8_t> starb;
+    std::vector<uint8_t> starbOrig;
+
+    GraphicsState* graphics = nullptr;
+
+    std::atomic<uint64_t> wordsExecuted{0};
+    std::atomic<uint64_t> wordsPerSecond{0};
+    std::atomic<uint32_t> virtualClockWordsPerMs{0};
+    std::atomic<uint64_t> virtualSleepMs{0};
+
+private:
+    static EmulatorContext& BindDefault();
+
+    static inline thread_local EmulatorContext* s_current = nullptr;
+};
+
+#endif
@@ -20,6 +20,7 @@
 
  
 #include "bios.h"
+#include "cpu8086state.h"
 
 #ifndef _WIN32
 #include <unistd.h>
@@ -35,7 +36,7 @@ typedef int ssize_t;
 // Emulator system constants
 #define IO_PORT_COUNT 0x10000
 #define RAM_SIZE 0x10FFF0
-#define REGS_BASE 0xF0000
+#define BIOS_BASE 0xF0000
 #define VIDEO_RAM_SIZE 0x10000
 
 // Graphics/timer/keyboard update delays (explained later)
@@ -104,14 +105,15 @@ typedef int ssize_t;
 
 // Helper macros
 
-// Decode mod, r_m and reg fields in instruction
+// Decode mod, r_m and reg fields in instruction. rm_addr is only set for a memory operand
 #define DECODE_RM_REG scratch2_uint = 4 * !i_mod, \
-					  op_to_addr = rm_addr = i_mod < 3 ? SEGREG(seg_override_en ? seg_override : bios_table_lookup[scratch2_uint + 3][i_rm], bios_table_lookup[scratch2_uint][i_rm], regs16[bios_table_lookup[scratch2_uint + 1][i_rm]] + bios_table_lookup[scratch2_uint + 2][i_rm] * i_data1+) : GET_REG_ADDR(i_rm), \
-					  op_from_addr = GET_REG_ADDR(i_reg), \
-					  i_d && (scratch_uint = op_from_addr, op_from_addr = rm_addr, op_to_addr = scratch_uint)
+					  op_to_ptr = rm_ptr = i_mod < 3 ? mem + (rm_addr = SEGREG(seg_override_en ? seg_override : bios_table_lookup[scratch2_uint + 3][i_rm], bios_table_lookup[scratch2_uint][i_rm], regs16[bios_table_lookup[scratch2_uint + 1][i_rm]] + bios_table_lookup[scratch2_uint + 2][i_rm] * i_data1+)) : GET_REG_PTR(i_rm), \
+					  op_from_ptr = GET_REG_PTR(i_reg), \
+					  i_d && (scratch_ptr = op_from_ptr, op_from_ptr = rm_ptr, op_to_ptr = scratch_ptr)
 
-// Return memory-mapped register location (offset into mem array) for register #reg_id
-#define GET_REG_ADDR(reg_id) (REGS_BASE + (i_w ? 2 * reg_id : 2 * reg_id + reg_id / 4 & 7))
+// Return the offset into regs8 of register #reg_id, and the register itself
+#define GET_REG_OFFSET(reg_id) (i_w ? 2 * reg_id : 2 * reg_id + reg_id / 4 & 7)
+#define GET_REG_PTR(reg_id) (regs8 + GET_REG_OFFSET(reg_id))
 
 // Returns number of top bit in operand (i.e. 8 for 8-bit operands, 16 for 16-bit operands)
 #define TOP_BIT 8*(i_w + 1)
@@ -122,21 +124,21 @@ typedef int ssize_t;
 
 // [I]MUL/[I]DIV/DAA/DAS/ADC/SBB helpers
 #define MUL_MACRO(op_data_type,out_regs) (set_opcode(0x10), \
-										  out_regs[i_w + 1] = (op_result = CAST(op_data_type)mem[rm_addr] * (op_data_type)*out_regs) >> 16, \
+										  out_regs[i_w + 1] = (op_result = CAST(op_data_type)*rm_ptr * (op_data_type)*out_regs) >> 16, \
 										  regs16[REG_AX] = op_result, \
 										  set_OF(set_CF(op_result - (op_data_type)op_result)))
-#define DIV_MACRO(out_data_type,in_data_type,out_regs) (scratch_int = CAST(out_data_type)mem[rm_addr]) && !(scratch2_uint = (in_data_type)(scratch_uint = (out_regs[i_w+1] << 16) + regs16[REG_AX]) / scratch_int, scratch2_uint - (out_data_type)scratch2_uint) ? out_regs[i_w+1] = scratch_uint - scratch_int * (*out_regs = scratch2_uint) : pc_interrupt(0)
+#define DIV_MACRO(out_data_type,in_data_type,out_regs) (scratch_int = CAST(out_data_type)*rm_ptr) && !(scratch2_uint = (in_data_type)(scratch_uint = (out_regs[i_w+1] << 16) + regs16[REG_AX]) / scratch_int, scratch2_uint - (out_data_type)scratch2_uint) ? out_regs[i_w+1] = scratch_uint - scratch_int * (*out_regs = scratch2_uint) : pc_interrupt(0)
 #define DAA_DAS(op1,op2,mask,min) set_AF((((scratch2_uint = regs8[REG_AL]) & 0x0F) > 9) || regs8[FLAG_AF]) && (op_result = regs8[REG_AL] op1 6, set_CF(regs8[FLAG_CF] || (regs8[REG_AL] op2 scratch2_uint))), \
 								  set_CF((((mask & 1 ? scratch2_uint : regs8[REG_AL]) & mask) > min) || regs8[FLAG_CF]) && (op_result = regs8[REG_AL] op1 0x60)
 #define ADC_SBB_MACRO(a) OP(a##= regs8[FLAG_CF] +), \
 						 set_CF(regs8[FLAG_CF] && (op_result == op_dest) || (a op_result < a(int)op_dest)), \
 						 set_AF_OF_arith()
 
-// Execute arithmetic/logic operations in emulator memory/registers
+// Execute arithmetic/logic operations in emulator memory/registers. Operands are lvalues, MEM_OP/OP take pointers
 #define R_M_OP(dest,op,src) (i_w ? op_dest = CAST(unsigned short)dest, op_result = CAST(unsigned short)dest op (op_source = CAST(unsigned short)src) \
 								 : (op_dest = dest, op_result = dest op (op_source = CAST(unsigned char)src)))
-#define MEM_OP(dest,op,src) R_M_OP(mem[dest],op,mem[src])
-#define OP(op) MEM_OP(op_to_addr,op,op_from_addr)
+#define MEM_OP(dest,op,src) R_M_OP(*(dest),op,*(src))
+#define OP(op) MEM_OP(op_to_ptr,op,op_from_ptr)
 
 // Increment or decrement a register #reg_id (usually SI or DI), depending on direction flag and operand size (given by i_w)
 #define INDEX_INC(reg_id) (regs16[reg_id] -= (2 * regs8[FLAG_DF] - 1)*(i_w + 1))
@@ -145,6 +147,28 @@ typedef int ssize_t;
 #define R_M_PUSH(a) (i_w = 1, R_M_OP(mem[SEGREG(REG_SS, REG_SP, --)], =, a))
 #define R_M_POP(a) (i_w = 1, regs16[REG_SP] += 2, R_M_OP(a, =, mem[SEGREG(REG_SS, REG_SP, -2+)]))
 
+// SF/ZF/PF and AF/OF are only computed when an instruction reads them (see LazyFlags), 0 = after every instruction
+#ifndef SF_8086_LAZY_FLAGS
+#define SF_8086_LAZY_FLAGS 1
+#endif
+#define LAZY_SZP 1
+#define LAZY_AF 2
+#define LAZY_OF 4
+
+// REP string instructions run all but their last element in bulk when possible (see rep_store_bulk), 0 = one at a time
+#ifndef SF_8086_REP_KERNELS
+#define SF_8086_REP_KERNELS 1
+#endif
+
+// The FORTH ending (NEXT) of an assembly routine, where Run8086 hands back to the Forth interpreter:
+// 0x22e1: lodsw
+// 0x22e2: mov    bx,ax
+// 0x22e4: jmp    word ptr [bx]
+// AD 8B D8 FF 27, as the low bytes of instruction_bytes(). The LODSW opcode byte is tested first so other
+// instructions cost one compare.
+#define FORTH_NEXT_BYTES 0x27FFD88BADull
+#define FORTH_NEXT_MASK 0xFFFFFFFFFFull
+
 // Convert segment:offset to linear address in emulator memory space
 #define SEGREG(reg_seg,reg_ofs,op) 16 * regs16[reg_seg] + (unsigned short)(op regs16[reg_ofs])
 
@@ -163,18 +187,35 @@ typedef int ssize_t;
 
 unsigned disassemble(unsigned seg, unsigned off, uint8_t *memory, int count);
 
-// Global variable definitions
-static uint8_t* mem;
-static uint8_t io_ports[IO_PORT_COUNT];
-static uint8_t *opcode_stream;
-static uint8_t *regs8;
-uint8_t i_rm, i_w, i_reg, i_mod, i_mod_size, i_d, i_reg4bit, raw_opcode_id, xlat_opcode_id, extra, rep_mode, seg_override_en, rep_override_en, trap_flag, int8_asap, scratch_uchar, io_hi_lo, *vid_mem_base, spkr_en, bios_table_lookup[20][256];
-static uint16_t *regs16;
-uint16_t reg_ip, seg_override, file_index, wave_counter;
-uint32_t op_source, op_dest, rm_addr, op_to_addr, op_from_addr, i_data0, i_data1, i_data2, scratch_uint, scratch2_uint, inst_counter, set_flags_type, GRAPHICS_X, GRAPHICS_Y, pixel_colors[16], vmem_ctr;
-int32_t op_result, disk[3], scratch_int;
-time_t clock_buf;
-struct timeb ms_clock;
+// Global variable definitions. Memory, I/O ports, the decode tables and the register
+// file (regs8/regs16) belong to the EmulatorContext bound by Bind8086(), the rest is
+// per-thread scratch.
+static thread_local uint8_t* mem;
+static thread_local uint8_t* io_ports;
+static thread_local uint8_t (*bios_table_lookup)[256];
+static thread_local uint8_t *opcode_stream;
+static thread_local uint8_t *regs8;
+static thread_local uint16_t *regs16;
+
+thread_local uint8_t i_rm, i_w, i_reg, i_mod, i_mod_size, i_d, i_reg4bit, raw_opcode_id, xlat_opcode_id, extra, rep_mode, seg_override_en, rep_override_en, trap_flag, int8_asap, scratch_uchar, io_hi_lo, *vid_mem_base, spkr_en;
+thread_local uint16_t reg_ip, seg_override, file_index, wave_counter;
+thread_local uint32_t op_source, op_dest, rm_addr, i_data0, i_data1, i_data2, scratch_uint, scratch2_uint, set_flags_type, GRAPHICS_X, GRAPHICS_Y, pixel_colors[16], vmem_ctr;
+thread_local int32_t op_result, disk[3], scratch_int;
+// Operands of the current instruction, into mem or the register file
+thread_local uint8_t *rm_ptr, *op_to_ptr, *op_from_ptr, *scratch_ptr;
+thread_local uint64_t inst_counter;
+thread_local time_t clock_buf;
+thread_local struct timeb ms_clock;
+
+// Flags owed by the last instructions that updated them. The values set_AF_OF_arith() and the SZP update
+// would have used are kept, and a flag bit is dropped again as soon as something else writes that flag.
+struct LazyFlags
+{
+	int32_t szp_result, ao_result;
+	uint32_t ao_source, ao_dest;
+	uint8_t pending, szp_w, ao_w, ao_cf;
+};
+static thread_local LazyFlags lazy_flags;
 
 // Helper functions
 
@@ -187,12 +228,14 @@ char set_CF(int new_CF)
 // Set auxiliary flag
 char set_AF(int new_AF)
 {
+	lazy_flags.pending &= ~LAZY_AF;
 	return regs8[FLAG_AF] = !!new_AF;
 }
 
 // Set overflow flag
 char set_OF(int new_OF)
 {
+	lazy_flags.pending &= ~LAZY_OF;
 	return regs8[FLAG_OF] = !!new_OF;
 }
 
@@ -206,9 +249,34 @@ char set_AF_OF_arith()
 		return set_OF(1 & (regs8[FLAG_CF] ^ op_source >> (TOP_BIT - 1)));
 }
 
+// Write the flags owed by LazyFlags to regs8[FLAG_xx], as the eager update would have
+void materialize_flags()
+{
+	const LazyFlags& lazy = lazy_flags;
+	if (lazy.pending & LAZY_SZP)
+	{
+		regs8[FLAG_SF] = 1 & lazy.szp_result >> (lazy.szp_w ? 15 : 7);
+		regs8[FLAG_ZF] = !lazy.szp_result;
+		regs8[FLAG_PF] = bios_table_lookup[TABLE_PARITY_FLAG][(unsigned char)lazy.szp_result];
+	}
+	if (lazy.pending & (LAZY_AF | LAZY_OF))
+	{
+		const uint32_t carries = lazy.ao_source ^ lazy.ao_dest ^ lazy.ao_result;
+		if (lazy.pending & LAZY_AF)
+			regs8[FLAG_AF] = !!(carries & 0x10);
+		if (lazy.pending & LAZY_OF)
+			regs8[FLAG_OF] = lazy.ao_result == lazy.ao_dest ? 0 : 1 & (lazy.ao_cf ^ carries >> (lazy.ao_w ? 15 : 7));
+	}
+	lazy_flags.pending = 0;
+}
+
+// Before an instruction reads SF/ZF/PF/AF/OF
+#define READ_LAZY_FLAGS (lazy_flags.pending && (materialize_flags(), 0))
+
 // Assemble and return emulated CPU FLAGS register in scratch_uint
 void make_flags()
 {
+	READ_LAZY_FLAGS;
 	scratch_uint = 0xF002; // 8086 has reserved and unused flags set to 1
 	for (int i = 9; i--;)
 		scratch_uint += regs8[FLAG_CF + i] << bios_table_lookup[TABLE_FLAGS_BITFIELDS][i];
@@ -217,6 +285,7 @@ void make_flags()
 // Set emulated CPU FLAGS register from regs8[FLAG_xx] values
 void set_flags(int new_flags)
 {
+	lazy_flags.pending = 0;
 	for (int i = 9; i--;)
 		regs8[FLAG_CF + i] = !!(1 << bios_table_lookup[TABLE_FLAGS_BITFIELDS][i] & new_flags);
 }
@@ -257,7 +326,7 @@ char pc_interrupt(unsigned char interrupt_num)
 	R_M_PUSH(scratch_uint);
 	R_M_PUSH(regs16[REG_CS]);
 	R_M_PUSH(reg_ip);
-	MEM_OP(REGS_BASE + 2 * REG_CS, =, 4 * interrupt_num + 2);
+	R_M_OP(regs16[REG_CS], =, mem[4 * interrupt_num + 2]);
 	R_M_OP(reg_ip, =, mem[4 * interrupt_num]);
 
 	return regs8[FLAG_TF] = regs8[FLAG_IF] = 0;
@@ -266,30 +335,163 @@ char pc_interrupt(unsigned char interrupt_num)
     return 0;
 }
 
+// Decode the instruction at opcode_stream into the i_xx/extra/set_flags_type variables. Only fields that
+// depend on the instruction bytes alone are set here, DECODE_RM_REG resolves the operands afterwards
+void decode_opcode()
+{
+	// Set up variables to prepare for decoding an opcode
+	set_opcode(*opcode_stream);
+
+	// Extract i_w and i_d fields from instruction
+	i_w = (i_reg4bit = raw_opcode_id & 7) & 1;
+	i_d = i_reg4bit / 2 & 1;
+
+	// Extract instruction data fields
+	i_data0 = CAST(short)opcode_stream[1];
+	i_data1 = CAST(short)opcode_stream[2];
+	i_data2 = CAST(short)opcode_stream[3];
+
+	// i_mod_size > 0 indicates that opcode uses i_mod/i_rm/i_reg, so decode them
+	if (i_mod_size)
+	{
+		i_mod = (i_data0 & 0xFF) >> 6;
+		i_rm = i_data0 & 7;
+		i_reg = i_data0 / 8 & 7;
+
+		if ((!i_mod && i_rm == 6) || (i_mod == 2))
+			i_data2 = CAST(short)opcode_stream[4];
+		else if (i_mod != 1)
+			i_data2 = i_data1;
+		else // If i_mod is 1, operand is (usually) 8 bits rather than 16 bits
+			i_data1 = (char)i_data1;
+	}
+}
+
+static inline uint64_t instruction_bytes(const uint8_t *stream)
+{
+	// Two loads rather than a 6 byte memcpy, which goes through the stack
+	uint32_t lo;
+	uint16_t hi;
+	memcpy(&lo, stream, 4);
+	memcpy(&hi, stream + 4, 2);
+	return lo | (uint64_t)hi << 32;
+}
+
 // AAA and AAS instructions - which_operation is +1 for AAA, and -1 for AAS
 int AAA_AAS(char which_operation)
 {
+	READ_LAZY_FLAGS;
 	return (regs16[REG_AX] += 262 * which_operation*set_AF(set_CF(((regs8[REG_AL] & 0x0F) > 9) || regs8[FLAG_AF])), regs8[REG_AL] &= 0x0F);
 }
 
-void Init8086(uint8_t* systemMemory)
+// REP string kernels. They only take the forward direction (DF clear) and ranges that do not wrap around
+// their segment, and stop one element short: the REP loop in Run8086 runs the last one, so op_dest,
+// op_result and the flags come from the same code as before. Anything else is left to the loop entirely.
+
+// Runs count elements of MOVSx (extra = 0) or STOSx (extra = 1) and returns count, or 0 if it cannot
+static uint32_t rep_store_bulk(uint32_t count)
+{
+	const uint32_t bytes = count * (i_w + 1);
+	if (regs8[FLAG_DF] || extra > 1 || regs16[REG_DI] + bytes > 0x10000)
+		return 0;
+
+	uint8_t *dest = mem + SEGREG(REG_ES, REG_DI,);
+	if (extra) // STOSx
+	{
+		if (!i_w || regs8[REG_AL] == regs8[REG_AH])
+			memset(dest, regs8[REG_AL], bytes);
+		else
+			for (uint32_t i = 0; i < bytes; i += 2)
+				memcpy(dest + i, regs8 + REG_AL, 2);
+	}
+	else // MOVSx
+	{
+		if (regs16[REG_SI] + bytes > 0x10000)
+			return 0;
+
+		// Copying forward one element at a time repeats the source when the destination starts inside it,
+		// which memmove would not
+		const uint8_t *source = mem + SEGREG(scratch2_uint, REG_SI,);
+		if (dest > source && dest < source + bytes)
+			return 0;
+
+		memmove(dest, source, bytes);
+		regs16[REG_SI] += bytes;
+	}
+	regs16[REG_DI] += bytes;
+	return count;
+}
+
+// Skips the elements of REPxx CMPSx (extra = 0) or SCASx (extra = 1) that do not end the loop, at most count
+static void rep_compare_skip(uint32_t count)
+{
+	const uint32_t size = i_w + 1;
+	if (regs8[FLAG_DF] || regs16[REG_DI] + count * size > 0x10000 || (!extra && regs16[REG_SI] + count * size > 0x10000))
+		return;
+
+	// SCASx compares AL/AX with every element
+	const uint8_t *dest = mem + SEGREG(REG_ES, REG_DI,);
+	const uint8_t *source = extra ? regs8 + REG_AL : mem + SEGREG(scratch2_uint, REG_SI,);
+	const uint32_t source_step = extra ? 0 : size;
+
+	// An element ends the loop when whether it compared equal differs from rep_mode (1 = REPZ, 0 = REPNZ)
+	uint32_t skipped = 0;
+	if (extra && !i_w && !rep_mode) // REPNZ SCASB
+	{
+		const uint8_t *found = (const uint8_t *)memchr(dest, regs8[REG_AL], count);
+		skipped = found ? found - dest : count;
+	}
+	else if (i_w)
+	{
+		for (uint16_t a, b; skipped < count; skipped++)
+		{
+			memcpy(&a, source + skipped * source_step, 2);
+			memcpy(&b, dest + 2 * skipped, 2);
+			if ((a == b) != rep_mode)
+				break;
+		}
+	}
+	else
+	{
+		while (skipped < count && (source[skipped * source_step] == dest[skipped]) == rep_mode)
+			skipped++;
+	}
+
+	regs16[REG_CX] -= skipped;
+	regs16[REG_DI] += skipped * size;
+	if (!extra)
+		regs16[REG_SI] += skipped * size;
+}
+
+void Bind8086(uint8_t* systemMemory, uint8_t* ioPorts, uint8_t (*biosTables)[256], Cpu8086State* state)
 {
     mem = systemMemory;
+    io_ports = ioPorts;
+    bios_table_lookup = biosTables;
 
-	// regs16 and reg8 point to F000:0, the start of memory-mapped registers. CS is initialised to F000
-	regs16 = (unsigned short *)(regs8 = mem + REGS_BASE);
+	regs8 = state->regs8;
+	regs16 = state->regs16;
+}
 
-	// Load BIOS from the bios array into F000:0100, and set IP to 0100
-	memcpy(regs8 + 0x100, bios, sizeof(bios));
+void Init8086()
+{
+	// Load BIOS from the bios array into F000:0100
+	uint8_t *bios_segment = mem + BIOS_BASE;
+	memcpy(bios_segment + 0x100, bios, sizeof(bios));
 
-	// Load instruction decoding helper table
+	// Load instruction decoding helper table. The BIOS keeps the table offsets at F000:0102
 	for (int i = 0; i < 20; i++)
 		for (int j = 0; j < 256; j++)
-			bios_table_lookup[i][j] = regs8[regs16[0x81 + i] + j];
+			bios_table_lookup[i][j] = bios_segment[CAST(unsigned short)bios_segment[2 * (0x81 + i)] + j];
 }
 
-extern unsigned short int regsi;
-extern unsigned short int regbp;
+extern thread_local unsigned short int regsi;
+extern thread_local unsigned short int regbp;
+
+uint64_t Get8086InstructionsExecuted()
+{
+	return inst_counter;
+}
 
 // Emulator entry point
 void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp)
@@ -312,21 +514,15 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 	// Instruction execution loop. Terminates if CS:IP = 0:0
 	for (;;)
 	{
-        opcode_stream = mem + (16 * regs16[REG_CS]) + reg_ip;
-
-		// Check to see if we're at the FORTH ending of this assembly routine.
-		// 0x22e1: lodsw
-		// 0x22e2: mov    bx,ax
-		// 0x22e4: jmp    word ptr [bx]
-		// AD 8B D8 FF 27
+		const uint32_t addr = 16 * regs16[REG_CS] + reg_ip;
+        opcode_stream = mem + addr;
 
-		const std::array<uint8_t, 5> forthEnding = { 0xAD, 0x8B, 0xD8, 0xFF, 0x27 };
-
-		if(memcmp(opcode_stream, forthEnding.data(), forthEnding.size()) == 0)
+		if (*opcode_stream == 0xAD && (instruction_bytes(opcode_stream) & FORTH_NEXT_MASK) == FORTH_NEXT_BYTES)
 		{
 			*regSp = regs16[REG_SP];
 			regbp = regs16[REG_BP];
 			regsi = regs16[REG_SI];
+			READ_LAZY_FLAGS;
 
 			uint16_t valEnd = *(uint16_t*)&mem[0x192l * 16l + 0x5dael];
 			if (valEnd != valStart)
@@ -339,17 +535,7 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 
         //disassemble(regs16[REG_CS], reg_ip, mem, 1);
 
-		// Set up variables to prepare for decoding an opcode
-		set_opcode(*opcode_stream);
-
-		// Extract i_w and i_d fields from instruction
-		i_w = (i_reg4bit = raw_opcode_id & 7) & 1;
-		i_d = i_reg4bit / 2 & 1;
-
-		// Extract instruction data fields
-		i_data0 = CAST(short)opcode_stream[1];
-		i_data1 = CAST(short)opcode_stream[2];
-		i_data2 = CAST(short)opcode_stream[3];
+		decode_opcode();
 
 		// seg_override_en and rep_override_en contain number of instructions to hold segment override and REP prefix respectively
 		if (seg_override_en)
@@ -357,33 +543,21 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 		if (rep_override_en)
 			rep_override_en--;
 
-		// i_mod_size > 0 indicates that opcode uses i_mod/i_rm/i_reg, so decode them
+		// i_mod_size > 0 indicates that opcode uses i_mod/i_rm/i_reg, which address registers or memory
 		if (i_mod_size)
-		{
-			i_mod = (i_data0 & 0xFF) >> 6;
-			i_rm = i_data0 & 7;
-			i_reg = i_data0 / 8 & 7;
-
-			if ((!i_mod && i_rm == 6) || (i_mod == 2))
-				i_data2 = CAST(short)opcode_stream[4];
-			else if (i_mod != 1)
-				i_data2 = i_data1;
-			else // If i_mod is 1, operand is (usually) 8 bits rather than 16 bits
-				i_data1 = (char)i_data1;
-
 			DECODE_RM_REG;
-		}
 
 		// Instruction execution unit
 		switch (xlat_opcode_id)
 		{
 			OPCODE_CHAIN 0: // Conditional jump (JAE, JNAE, etc.)
 				// i_w is the invert flag, e.g. i_w == 1 means JNAE, whereas i_w == 0 means JAE 
+				READ_LAZY_FLAGS;
 				scratch_uchar = raw_opcode_id / 2 & 7;
 				reg_ip += (char)i_data0 * (i_w ^ (regs8[bios_table_lookup[TABLE_COND_JUMP_DECODE_A][scratch_uchar]] || regs8[bios_table_lookup[TABLE_COND_JUMP_DECODE_B][scratch_uchar]] || regs8[bios_table_lookup[TABLE_COND_JUMP_DECODE_C][scratch_uchar]] ^ regs8[bios_table_lookup[TABLE_COND_JUMP_DECODE_D][scratch_uchar]]))
 			OPCODE 1: // MOV reg, imm
 				i_w = !!(raw_opcode_id & 8);
-				R_M_OP(mem[GET_REG_ADDR(i_reg4bit)], =, i_data0)
+				R_M_OP(*GET_REG_PTR(i_reg4bit), =, i_data0)
 			OPCODE 3: // PUSH regs16
 				R_M_PUSH(regs16[i_reg4bit])
 			OPCODE 4: // POP regs16
@@ -396,7 +570,7 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 				i_reg = extra
 			OPCODE_CHAIN 5: // INC|DEC|JMP|CALL|PUSH
 				if (i_reg < 2) // INC|DEC
-					MEM_OP(op_from_addr, += 1 - 2 * i_reg +, REGS_BASE + 2 * REG_ZERO),
+					R_M_OP(*op_from_ptr, += 1 - 2 * i_reg +, regs16[REG_ZERO]),
 					op_source = 1,
 					set_AF_OF_arith(),
 					set_OF(op_dest + 1 - i_reg == 1 << (TOP_BIT - 1)),
@@ -404,20 +578,20 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 				else if (i_reg != 6) // JMP|CALL
 					i_reg - 3 || R_M_PUSH(regs16[REG_CS]), // CALL (far)
 					i_reg & 2 && R_M_PUSH(reg_ip + 2 + i_mod*(i_mod != 3) + 2*(!i_mod && i_rm == 6)), // CALL (near or far)
-					i_reg & 1 && (regs16[REG_CS] = CAST(short)mem[op_from_addr + 2]), // JMP|CALL (far)
-					R_M_OP(reg_ip, =, mem[op_from_addr]),
+					i_reg & 1 && (regs16[REG_CS] = CAST(short)op_from_ptr[2]), // JMP|CALL (far)
+					R_M_OP(reg_ip, =, *op_from_ptr),
 					set_opcode(0x9A); // Decode like CALL
 				else // PUSH
-					R_M_PUSH(mem[rm_addr])
+					R_M_PUSH(*rm_ptr)
 			OPCODE 6: // TEST r/m, imm16 / NOT|NEG|MUL|IMUL|DIV|IDIV reg
-				op_to_addr = op_from_addr;
+				op_to_ptr = op_from_ptr;
 
 				switch (i_reg)
 				{
 					OPCODE_CHAIN 0: // TEST
 						set_opcode(0x20); // Decode like AND
 						reg_ip += i_w + 1;
-						R_M_OP(mem[op_to_addr], &, i_data2)
+						R_M_OP(*op_to_ptr, &, i_data2)
 					OPCODE 2: // NOT
 						OP(=~)
 					OPCODE 3: // NEG
@@ -435,15 +609,15 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 						i_w ? DIV_MACRO(short, int, regs16) : DIV_MACRO(char, short, regs8);
 				}
 			OPCODE 7: // ADD|OR|ADC|SBB|AND|SUB|XOR|CMP AL/AX, immed
-				rm_addr = REGS_BASE;
+				rm_ptr = regs8;
 				i_data2 = i_data0;
 				i_mod = 3;
 				i_reg = extra;
 				reg_ip--;
 			OPCODE_CHAIN 8: // ADD|OR|ADC|SBB|AND|SUB|XOR|CMP reg, immed
-				op_to_addr = rm_addr;
+				op_to_ptr = rm_ptr;
 				regs16[REG_SCRATCH] = (i_d |= !i_w) ? (char)i_data2 : i_data2;
-				op_from_addr = REGS_BASE + 2 * REG_SCRATCH;
+				op_from_ptr = (uint8_t*)&regs16[REG_SCRATCH];
 				reg_ip += !i_d + 1;
 				set_opcode(0x08 * (extra = i_reg));
 			OPCODE_CHAIN 9: // ADD|OR|ADC|SBB|AND|SUB|XOR|CMP|MOV reg, r/m
@@ -481,17 +655,17 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 					seg_override_en = 1,
 					seg_override = REG_ZERO,
 					DECODE_RM_REG,
-					R_M_OP(mem[op_from_addr], =, rm_addr);
+					R_M_OP(*op_from_ptr, =, rm_addr);
 				else // POP
-					R_M_POP(mem[rm_addr])
+					R_M_POP(*rm_ptr)
 			OPCODE 11: // MOV AL/AX, [loc]
 				i_mod = i_reg = 0;
 				i_rm = 6;
 				i_data1 = i_data0;
 				DECODE_RM_REG;
-				MEM_OP(op_from_addr, =, op_to_addr)
+				MEM_OP(op_from_ptr, =, op_to_ptr)
 			OPCODE 12: // ROL|ROR|RCL|RCR|SHL|SHR|???|SAR reg/mem, 1/CL/imm (80186)
-				scratch2_uint = SIGN_OF(mem[rm_addr]),
+				scratch2_uint = SIGN_OF(*rm_ptr),
 				scratch_uint = extra ? // xxx reg/mem, imm
 					++reg_ip,
 					(char)i_data1
@@ -504,11 +678,11 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 				{
 					if (i_reg < 4) // Rotate operations
 						scratch_uint %= i_reg / 2 + TOP_BIT,
-						R_M_OP(scratch2_uint, =, mem[rm_addr]);
+						R_M_OP(scratch2_uint, =, *rm_ptr);
 					if (i_reg & 1) // Rotate/shift right operations
-						R_M_OP(mem[rm_addr], >>=, scratch_uint);
+						R_M_OP(*rm_ptr, >>=, scratch_uint);
 					else // Rotate/shift left operations
-						R_M_OP(mem[rm_addr], <<=, scratch_uint);
+						R_M_OP(*rm_ptr, <<=, scratch_uint);
 					if (i_reg > 3) // Shift operations
 						set_opcode(0x10); // Decode like ADC
 					if (i_reg > 4) // SHR or SAR
@@ -518,17 +692,17 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 				switch (i_reg)
 				{
 					OPCODE_CHAIN 0: // ROL
-						R_M_OP(mem[rm_addr], += , scratch2_uint >> (TOP_BIT - scratch_uint));
+						R_M_OP(*rm_ptr, += , scratch2_uint >> (TOP_BIT - scratch_uint));
 						set_OF(SIGN_OF(op_result) ^ set_CF(op_result & 1))
 					OPCODE 1: // ROR
 						scratch2_uint &= (1 << scratch_uint) - 1,
-						R_M_OP(mem[rm_addr], += , scratch2_uint << (TOP_BIT - scratch_uint));
+						R_M_OP(*rm_ptr, += , scratch2_uint << (TOP_BIT - scratch_uint));
 						set_OF(SIGN_OF(op_result * 2) ^ set_CF(SIGN_OF(op_result)))
 					OPCODE 2: // RCL
-						R_M_OP(mem[rm_addr], += (regs8[FLAG_CF] << (scratch_uint - 1)) + , scratch2_uint >> (1 + TOP_BIT - scratch_uint));
+						R_M_OP(*rm_ptr, += (regs8[FLAG_CF] << (scratch_uint - 1)) + , scratch2_uint >> (1 + TOP_BIT - scratch_uint));
 						set_OF(SIGN_OF(op_result) ^ set_CF(scratch2_uint & 1 << (TOP_BIT - scratch_uint)))
 					OPCODE 3: // RCR
-						R_M_OP(mem[rm_addr], += (regs8[FLAG_CF] << (TOP_BIT - scratch_uint)) + , scratch2_uint << (1 + TOP_BIT - scratch_uint));
+						R_M_OP(*rm_ptr, += (regs8[FLAG_CF] << (TOP_BIT - scratch_uint)) + , scratch2_uint << (1 + TOP_BIT - scratch_uint));
 						set_CF(scratch2_uint & 1 << (scratch_uint - 1));
 						set_OF(SIGN_OF(op_result) ^ SIGN_OF(op_result * 2))
 					OPCODE 4: // SHL
@@ -538,9 +712,10 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 					OPCODE 7: // SAR
 						scratch_uint < TOP_BIT || set_CF(scratch2_uint);
 						set_OF(0);
-						R_M_OP(mem[rm_addr], +=, scratch2_uint *= ~(((1 << TOP_BIT) - 1) >> scratch_uint));
+						R_M_OP(*rm_ptr, +=, scratch2_uint *= ~(((1 << TOP_BIT) - 1) >> scratch_uint));
 				}
 			OPCODE 13: // LOOPxx|JCZX
+				READ_LAZY_FLAGS;
 				scratch_uint = !!--regs16[REG_CX];
 
 				switch(i_reg4bit)
@@ -565,22 +740,27 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 				}
 				reg_ip += i_d && i_w ? (char)i_data0 : i_data0
 			OPCODE 15: // TEST reg, r/m
-				MEM_OP(op_from_addr, &, op_to_addr)
+				MEM_OP(op_from_ptr, &, op_to_ptr)
 			OPCODE 16: // XCHG AX, regs16
 				i_w = 1;
-				op_to_addr = REGS_BASE;
-				op_from_addr = GET_REG_ADDR(i_reg4bit);
+				op_to_ptr = regs8;
+				op_from_ptr = GET_REG_PTR(i_reg4bit);
 			OPCODE_CHAIN 24: // NOP|XCHG reg, r/m
-				if (op_to_addr != op_from_addr)
+				if (op_to_ptr != op_from_ptr)
 					OP(^=),
-					MEM_OP(op_from_addr, ^=, op_to_addr),
+					MEM_OP(op_from_ptr, ^=, op_to_ptr),
 					OP(^=)
 			OPCODE 17: // MOVSx (extra=0)|STOSx (extra=1)|LODSx (extra=2)
 				scratch2_uint = seg_override_en ? seg_override : REG_DS;
+				scratch_uint = rep_override_en ? regs16[REG_CX] : 1;
+#if SF_8086_REP_KERNELS
+				if (scratch_uint > 1)
+					scratch_uint -= rep_store_bulk(scratch_uint - 1);
+#endif
 
-				for (scratch_uint = rep_override_en ? regs16[REG_CX] : 1; scratch_uint; scratch_uint--)
+				for (; scratch_uint; scratch_uint--)
 				{
-					MEM_OP(extra < 2 ? SEGREG(REG_ES, REG_DI,) : REGS_BASE, =, extra & 1 ? REGS_BASE : SEGREG(scratch2_uint, REG_SI,)),
+					MEM_OP(extra < 2 ? mem + SEGREG(REG_ES, REG_DI,) : regs8, =, extra & 1 ? regs8 : mem + SEGREG(scratch2_uint, REG_SI,)),
 					extra & 1 || INDEX_INC(REG_SI),
 					extra & 2 || INDEX_INC(REG_DI);
 				}
@@ -592,9 +772,13 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 
 				if ((scratch_uint = rep_override_en ? regs16[REG_CX] : 1))
 				{
+#if SF_8086_REP_KERNELS
+					if (scratch_uint > 1)
+						rep_compare_skip(scratch_uint - 1);
+#endif
 					for (; scratch_uint; rep_override_en || scratch_uint--)
 					{
-						MEM_OP(extra ? REGS_BASE : SEGREG(scratch2_uint, REG_SI,), -, SEGREG(REG_ES, REG_DI,)),
+						MEM_OP(extra ? regs8 : mem + SEGREG(scratch2_uint, REG_SI,), -, mem + SEGREG(REG_ES, REG_DI,)),
 						extra || INDEX_INC(REG_SI),
 						INDEX_INC(REG_DI), rep_override_en && !(--regs16[REG_CX] && (!op_result == rep_mode)) && (scratch_uint = 0);
 					}
@@ -612,7 +796,7 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 				else if (!i_d) // RET|RETF imm16
 					regs16[REG_SP] += i_data0
 			OPCODE 20: // MOV r/m, immed
-				R_M_OP(mem[op_from_addr], =, i_data2)
+				R_M_OP(*op_from_ptr, =, i_data2)
 			OPCODE 21: // IN AL/AX, DX/imm8
 				io_ports[0x20] = 0; // PIC EOI
 				io_ports[0x42] = --io_ports[0x40]; // PIT channel 0/2 read placeholder
@@ -644,6 +828,7 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 				seg_override = extra;
 				rep_override_en && rep_override_en++
 			OPCODE 28: // DAA/DAS
+				READ_LAZY_FLAGS;
 				i_w = 0;
 				extra ? DAA_DAS(-=, >=, 0xFF, 0x99) : DAA_DAS(+=, <, 0xF0, 0x90) // extra = 0 for DAA, 1 for DAS
 			OPCODE 29: // AAA/AAS
@@ -672,7 +857,7 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 				i_w = i_d = 1;
 				DECODE_RM_REG;
 				OP(=);
-				MEM_OP(REGS_BASE + extra, =, rm_addr + 2)
+				MEM_OP(regs8 + extra, =, rm_ptr + 2)
 			OPCODE 38: // INT 3
 				++reg_ip;
 				pc_interrupt(3)
@@ -681,6 +866,7 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 				pc_interrupt(i_data0)
 			OPCODE 40: // INTO
 				++reg_ip;
+				READ_LAZY_FLAGS;
 				regs8[FLAG_OF] && pc_interrupt(4)
 			OPCODE 41: // AAM
 				if (i_data0 &= 0xFF)
@@ -736,6 +922,21 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 		// If instruction needs to update SF, ZF and PF, set them as appropriate
 		if (set_flags_type & FLAGS_UPDATE_SZP)
 		{
+#if SF_8086_LAZY_FLAGS
+			lazy_flags.szp_result = op_result;
+			lazy_flags.szp_w = i_w;
+			lazy_flags.pending |= LAZY_SZP;
+
+			// If instruction is an arithmetic or logic operation, also set AF/OF/CF as appropriate.
+			// set_AF_OF_arith() reads CF as it is now, so that is kept with the operands
+			if (set_flags_type & FLAGS_UPDATE_AO_ARITH)
+				lazy_flags.ao_result = op_result,
+				lazy_flags.ao_source = op_source,
+				lazy_flags.ao_dest = op_dest,
+				lazy_flags.ao_w = i_w,
+				lazy_flags.ao_cf = regs8[FLAG_CF],
+				lazy_flags.pending |= LAZY_AF | LAZY_OF;
+#else
 			regs8[FLAG_SF] = SIGN_OF(op_result);
 			regs8[FLAG_ZF] = !op_result;
 			regs8[FLAG_PF] = bios_table_lookup[TABLE_PARITY_FLAG][(unsigned char)op_result];
@@ -743,6 +944,7 @@ void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp
 			// If instruction is an arithmetic or logic operation, also set AF/OF/CF as appropriate.
 			if (set_flags_type & FLAGS_UPDATE_AO_ARITH)
 				set_AF_OF_arith();
+#endif
 			if (set_flags_type & FLAGS_UPDATE_OC_LOGIC)
 				set_CF(0), set_OF(0);
 		}
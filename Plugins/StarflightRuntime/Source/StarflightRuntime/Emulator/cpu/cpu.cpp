@@ -4,15 +4,21 @@
 
 #include <stdio.h>
 #include "../callstack.h"
+#include "../context.h"
+#include "../graphics.h"
 
-__declspec(align(4096)) unsigned char m[SystemMemorySize];
-__declspec(align(4096)) unsigned char *mem = nullptr;
-__declspec(align(4096)) unsigned short regsp = 0;
-__declspec(align(4096)) unsigned short regbp = 0;
-__declspec(align(4096)) unsigned short regsi = 0; // current vocabulary address (the forth pc pointer)
-__declspec(align(4096)) unsigned short regbx = 0;
+thread_local unsigned char *m = nullptr;
+thread_local unsigned char *mem = nullptr;
+thread_local unsigned short regsp = 0;
+thread_local unsigned short regbp = 0;
+thread_local unsigned short regsi = 0; // current vocabulary address (the forth pc pointer)
+thread_local unsigned short regbx = 0;
 
 #if !defined(USE_INLINE_MEMORY)
+// Text page at B800:0000, stores there are reported to GraphicsTextWritten()
+static constexpr unsigned long TextPageAddress = 0xB8000;
+static constexpr unsigned long TextPageBytes = 80 * 25 * 2;
+
 #if 0
 unsigned long ComputeAddress(unsigned short segment, unsigned short offset)
 {
@@ -42,6 +48,11 @@ void Write8Long(unsigned short s, unsigned short o, unsigned char x)
 
     m[addr] = x;
 
+    if (addr - TextPageAddress < TextPageBytes)
+    {
+        GraphicsTextWritten(addr, 1);
+    }
+
     #if 0
     if(addr == 0x7d20)
     {
@@ -131,15 +142,23 @@ unsigned short Pop()
 
 #endif
 
-unsigned char* currentMemory = m;
-uint16_t* RandomSeed = reinterpret_cast<uint16_t*>(&currentMemory[seedOffset]);
+thread_local unsigned char* currentMemory = nullptr;
+thread_local uint16_t* RandomSeed = nullptr;
+
+void BindCPU(unsigned char* systemMemory)
+{
+    m = systemMemory;
+    mem = &m[StarflightBaseSegment << 4];
+    currentMemory = m;
+    RandomSeed = reinterpret_cast<uint16_t*>(&currentMemory[seedOffset]);
+}
 
 void InitCPU()
 {
-    regsi = 0x129;
+    EmulatorContext::Current(); // binds the default context if this thread has none
+
     memset(m, 0, SystemMemorySize);
-    mem = &m[StarflightBaseSegment << 4];
-    Init8086(m);
+    Init8086();
 }
 
 
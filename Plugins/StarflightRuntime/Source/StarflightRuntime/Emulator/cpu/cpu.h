@@ -4,15 +4,18 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "cpu8086state.h"
+
 constexpr uint32_t StarflightBaseSegment = 0x192;
 constexpr uint32_t SystemMemorySize = 0x10FFF0;
 
-extern unsigned char *mem;
-extern unsigned char m[SystemMemorySize];
-extern unsigned short regsp;
-extern unsigned short regbp;
-extern unsigned short regsi;
-extern unsigned short regbx;
+// Bound per thread by EmulatorContext::MakeCurrent(), see context.h
+extern thread_local unsigned char *mem;
+extern thread_local unsigned char *m;
+extern thread_local unsigned short regsp;
+extern thread_local unsigned short regbp;
+extern thread_local unsigned short regsi;
+extern thread_local unsigned short regbx;
 
 #if !defined(USE_INLINE_MEMORY)
 void Write8(unsigned short offset, unsigned char x);
@@ -33,9 +36,9 @@ void Push(unsigned short x);
 unsigned short Pop();
 
 // Keep MemoryScope and related declarations available in non-inline mode
-extern unsigned char* currentMemory;
+extern thread_local unsigned char* currentMemory;
 static constexpr uint32_t seedOffset = ComputeAddress(StarflightBaseSegment, 0x4ab0);
-extern uint16_t* RandomSeed;
+extern thread_local uint16_t* RandomSeed;
 
 #ifdef _WIN32
 #ifndef DWORD
@@ -73,7 +76,9 @@ public:
         currentMemory = memory;
         RandomSeed = reinterpret_cast<uint16_t*>(&currentMemory[seedOffset]);
 
+#ifdef _WIN32
         VirtualProtect(previous, SystemMemorySize, PAGE_NOACCESS, &previousProtect);
+#endif
     }
     ~MemoryScope() {
         regsp = previousCPU.regsp;
@@ -84,17 +89,19 @@ public:
         currentMemory = previous;
         RandomSeed = reinterpret_cast<uint16_t*>(&currentMemory[seedOffset]);
 
+#ifdef _WIN32
         DWORD oldProtect;
         VirtualProtect(previous, SystemMemorySize, previousProtect, &oldProtect);
+#endif
     }
 };
 #else
 
 #define ComputeAddress(segment, offset) (((unsigned long)(segment) << 4) + (offset))
 
-extern unsigned char* currentMemory;
+extern thread_local unsigned char* currentMemory;
 static constexpr uint32_t seedOffset = ComputeAddress(StarflightBaseSegment, 0x4ab0);
-extern uint16_t* RandomSeed;
+extern thread_local uint16_t* RandomSeed;
 
 #ifdef _WIN32
 #ifndef DWORD
@@ -132,7 +139,9 @@ public:
         currentMemory = memory;    
         RandomSeed = reinterpret_cast<uint16_t*>(&currentMemory[seedOffset]);
 
+#ifdef _WIN32
         VirtualProtect(previous, SystemMemorySize, PAGE_NOACCESS, &previousProtect);
+#endif
     }
     ~MemoryScope() { 
         regsp = previousCPU.regsp;
@@ -143,8 +152,10 @@ public:
         currentMemory = previous;
         RandomSeed = reinterpret_cast<uint16_t*>(&currentMemory[seedOffset]);
 
+#ifdef _WIN32
         DWORD oldProtect;
         VirtualProtect(previous, SystemMemorySize, previousProtect, &oldProtect);
+#endif
     }
 };
 
@@ -239,10 +250,13 @@ inline uint16_t Pop() {
 #endif // USE_INLINE_MEMORY
 
 void InitCPU();
+void BindCPU(unsigned char* systemMemory);
 
 // Actual 8086 emulator, exposed in 8086emu.cpp
-void Init8086(uint8_t* systemMemory);
+void Bind8086(uint8_t* systemMemory, uint8_t* ioPorts, uint8_t (*biosTables)[256], Cpu8086State* state);
+void Init8086();
 void Run8086(uint16_t cs, uint16_t ip, uint16_t ds, uint16_t ss, uint16_t *regSp);
 unsigned disassemble(unsigned seg, unsigned off, uint8_t *memory, int count);
+uint64_t Get8086InstructionsExecuted();
 
 #endif
@@ -0,0 +1,19 @@
+#ifndef CPU8086STATE_H
+#define CPU8086STATE_H
+
+#include <stdint.h>
+
+// Register file of the 8086 core, one per EmulatorContext (see Bind8086). The
+// layout is the one the 8086tiny BIOS tables index: AX..DI, ES/CS/SS/DS, a zero
+// and a scratch word as regs16[0..13], AL/AH..BL/BH as regs8[0..7], and the
+// flags as one byte each from regs8[40] (FLAG_CF) to regs8[48] (FLAG_OF).
+struct alignas(64) Cpu8086State
+{
+    union
+    {
+        uint16_t regs16[32];
+        uint8_t regs8[64];
+    };
+};
+
+#endif
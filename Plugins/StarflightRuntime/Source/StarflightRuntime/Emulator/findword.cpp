@@ -7,9 +7,8 @@
 #include<stdlib.h>
 #include<string.h>
 
-#include <string>
 #include <algorithm>
-#include <unordered_map>
+#include <vector>
 
 #include"cpu/cpu.h"
 #include"callstack.h"
@@ -36,120 +35,234 @@ const char* GetOverlayName(int ovidx)
     return overlays[ovidx].name;
 }
 
-int FindClosestWord(int si, int ovidx)
+// ------------------------------------------------
+// Dictionary index
+//
+// Built once from dictionary.h. Words are grouped by overlay, group 0 holds
+// the words of the base image (ov == -1) and group i+1 those of overlay i.
+// Within a group entries are sorted by word address and dictionary order, so
+// a lookup returns the same entry as a linear scan would.
+// ------------------------------------------------
+
+struct WordIndexEntry
 {
-    int dist = 0x10000;
-    int i = 0;
-    int word = -1;
-    do
+    uint16_t word;
+    uint16_t index; // into dictionary[]
+};
+
+struct NameIndexEntry
+{
+    uint32_t hash;
+    uint16_t index;
+};
+
+struct DictionaryIndex
+{
+    std::vector<WordIndexEntry> words;
+    std::vector<uint32_t> groupStart;
+    std::vector<NameIndexEntry> names; // sorted by hash, then dictionary order
+};
+
+static uint32_t HashName(const char* s, int n)
+{
+    uint32_t hash = 2166136261u; // FNV-1a
+    for (int i = 0; i < n; i++)
     {
-        if ((dictionary[i].ov != ovidx) && (dictionary[i].ov != -1)) continue;
-        int d = si - dictionary[i].word;
-        if (d < 0) continue;
-        if (d < dist)
-        {
-            dist = d;
-            word = dictionary[i].word;
-        }
-    } while(dictionary[++i].name != NULL);
-    return word;
+        hash ^= (uint8_t)tolower((unsigned char)s[i]);
+        hash *= 16777619u;
+    }
+    return hash;
 }
 
-// ugly code to get our own overlay index from the address in the star file
-int GetOverlayIndex(int address, const char** overlayName)
+static DictionaryIndex BuildDictionaryIndex()
 {
-    struct OverlayData
+    DictionaryIndex index;
+
+    int count = 0;
+    int groups = 1;
+    while (dictionary[count].name != NULL)
     {
-        std::string name;
-        int index;
-    };
+        groups = std::max(groups, dictionary[count].ov + 2);
+        count++;
+    }
 
-    static std::unordered_map<int, OverlayData> overlapMap;
+    index.words.reserve(count);
+    index.names.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        index.words.push_back({ dictionary[i].word, (uint16_t)i });
+        index.names.push_back({ HashName(dictionary[i].name, (int)strlen(dictionary[i].name)), (uint16_t)i });
+    }
 
-    if(overlapMap.empty())
+    std::stable_sort(index.words.begin(), index.words.end(), [](const WordIndexEntry& a, const WordIndexEntry& b) {
+        int groupA = dictionary[a.index].ov + 1;
+        int groupB = dictionary[b.index].ov + 1;
+        if (groupA != groupB) return groupA < groupB;
+        return a.word < b.word;
+    });
+    std::stable_sort(index.names.begin(), index.names.end(), [](const NameIndexEntry& a, const NameIndexEntry& b) {
+        return a.hash < b.hash;
+    });
+
+    index.groupStart.assign(groups + 1, 0);
+    for (const WordIndexEntry& entry : index.words)
+    {
+        index.groupStart[dictionary[entry.index].ov + 2]++;
+    }
+    for (int i = 1; i <= groups; i++)
     {
-        overlapMap[0] = {"", -1};
+        index.groupStart[i] += index.groupStart[i - 1];
     }
 
-    auto it = overlapMap.find(address);
+    return index;
+}
+
+static const DictionaryIndex& GetDictionaryIndex()
+{
+    static const DictionaryIndex s_index = BuildDictionaryIndex();
+    return s_index;
+}
+
+static const WordIndexEntry* GroupBegin(const DictionaryIndex& index, int ovidx)
+{
+    return index.words.data() + index.groupStart[ovidx + 1];
+}
+
+static const WordIndexEntry* GroupEnd(const DictionaryIndex& index, int ovidx)
+{
+    return index.words.data() + index.groupStart[ovidx + 2];
+}
 
-    if(it != overlapMap.end())
+static bool HasGroup(const DictionaryIndex& index, int ovidx)
+{
+    return ovidx >= 0 && ovidx + 2 < (int)index.groupStart.size();
+}
+
+// First dictionary entry for word that is visible from overlay ovidx, or -1
+static int FindDictionaryIndex(int word, int ovidx)
+{
+    const DictionaryIndex& index = GetDictionaryIndex();
+    auto less = [](const WordIndexEntry& e, int w) { return e.word < w; };
+
+    int result = -1;
+    const WordIndexEntry* end = GroupEnd(index, -1);
+    const WordIndexEntry* it = std::lower_bound(GroupBegin(index, -1), end, word, less);
+    if (it != end && it->word == word)
+        result = it->index;
+
+    if (HasGroup(index, ovidx))
     {
-        if(overlayName != nullptr)
-        {
-            *overlayName = it->second.name.c_str();
-        }
-        return it->second.index;
+        end = GroupEnd(index, ovidx);
+        it = std::lower_bound(GroupBegin(index, ovidx), end, word, less);
+        if (it != end && it->word == word && (result == -1 || it->index < result))
+            result = it->index;
     }
 
-    for(int i = 0; dir[i].name != NULL; i++)
+    return result;
+}
+
+static int FindClosestInGroup(const DictionaryIndex& index, int ovidx, int si)
+{
+    const WordIndexEntry* begin = GroupBegin(index, ovidx);
+    const WordIndexEntry* it = std::upper_bound(begin, GroupEnd(index, ovidx), si,
+        [](int s, const WordIndexEntry& e) { return s < e.word; });
+    return it == begin ? -1 : (it - 1)->word;
+}
+
+int FindClosestWord(int si, int ovidx)
+{
+    const DictionaryIndex& index = GetDictionaryIndex();
+
+    int word = FindClosestInGroup(index, -1, si);
+    if (HasGroup(index, ovidx))
+        word = std::max(word, FindClosestInGroup(index, ovidx, si));
+    return word;
+}
+
+// ------------------------------------------------
+// Overlay index
+//
+// "OV#" holds the segment the current overlay was loaded to. Every segment
+// that starts an overlay in dir[] is resolved once into a flat 64K table, so
+// the lookup done for every word is a single load.
+// ------------------------------------------------
+
+static const int16_t OVERLAY_UNKNOWN = -2;
+
+struct OverlayTable
+{
+    int16_t index[0x10000];
+};
+
+static const OverlayTable& GetOverlayTable()
+{
+    static const OverlayTable* s_table = []()
     {
-        if ((address<<4) == dir[i].start)
+        static OverlayTable table;
+        std::fill(std::begin(table.index), std::end(table.index), OVERLAY_UNKNOWN);
+        table.index[0] = -1;
+
+        for(int i = 0; dir[i].name != NULL; i++)
         {
-            int idx = dir[i].idx;
+            if ((dir[i].start & 0xF) != 0 || (dir[i].start >> 4) > 0xFFFF) continue;
+            int16_t& entry = table.index[dir[i].start >> 4];
+            if (entry != OVERLAY_UNKNOWN) continue;
+
             for(int j = 0; overlays[j].name != NULL; j++)
             {
-                if (overlays[j].id == idx) 
+                if (overlays[j].id == dir[i].idx)
                 {
-                    OverlayData od{};
-                    od.index = j;
-                    od.name = std::string(overlays[j].name);
-                    auto itNew = overlapMap.emplace(address, od);
-
-                    if(overlayName != nullptr)
-                    {
-                        *overlayName = itNew.first->second.name.c_str();
-                    }
-
-                    return od.index;
+                    entry = (int16_t)j;
+                    break;
                 }
             }
         }
-    }
-
-    UE_LOG(LogStarflightFindword, Fatal, TEXT("Cannot find index for address 0x%04x"), address);
-    return -1; // Fatal will terminate, but return for completeness
+        return &table;
+    }();
+    return *s_table;
 }
 
-const SF_WORD* GetWord(int word, int ovidx)
+// get our own overlay index from the address in the star file
+int GetOverlayIndex(int address, const char** overlayName)
 {
-    if (ovidx == -1) ovidx = GetOverlayIndex(Read16(0x55a5), nullptr); // "OV#"
+    int index = GetOverlayTable().index[address & 0xFFFF];
 
-    for(int i = 0; dictionary[i].name != NULL; i++)
+    if (index == OVERLAY_UNKNOWN)
     {
-        if(dictionary[i].ov != -1 && dictionary[i].ov != ovidx)
-            continue;
+        UE_LOG(LogStarflightFindword, Fatal, TEXT("Cannot find index for address 0x%04x"), address);
+        return -1; // Fatal will terminate, but return for completeness
+    }
 
-        if (word == dictionary[i].word)
-        {
-            return (const SF_WORD*)&dictionary[i];
-        }
+    if(overlayName != nullptr)
+    {
+        *overlayName = (index == -1) ? "" : overlays[index].name;
     }
+    return index;
+}
 
-    return nullptr;
+int GetCurrentOverlayIndex()
+{
+    return GetOverlayIndex(Read16(0x55a5), nullptr); // "OV#"
 }
 
-static std::unordered_map<int, std::unordered_map<int, const char*>> s_wordDictionary{};
+const SF_WORD* GetWord(int word, int ovidx)
+{
+    if (ovidx == -1) ovidx = GetCurrentOverlayIndex();
+
+    int i = FindDictionaryIndex(word, ovidx);
+    return i == -1 ? nullptr : (const SF_WORD*)&dictionary[i];
+}
 
 const char* FindWordCanFail(int word, int& ovidx, int canFail)
 {
-    if (ovidx == -1) ovidx = GetOverlayIndex(Read16(0x55a5), nullptr); // "OV#"
-
-    auto& overlayDictionary = s_wordDictionary[ovidx];
-    auto it = overlayDictionary.find(word);
-    if (it != overlayDictionary.end()) return it->second;
+    if (ovidx == -1) ovidx = GetCurrentOverlayIndex();
 
-    int i = 0;
-    do
+    int i = FindDictionaryIndex(word, ovidx);
+    if (i != -1)
     {
-        if ((dictionary[i].ov != ovidx) && (dictionary[i].ov != -1)) continue;
-        if (word == dictionary[i].word) 
-        {
-            overlayDictionary[word] = dictionary[i].name;
-            ovidx = dictionary[i].ov;
-            return dictionary[i].name;
-        }
-    } while(dictionary[++i].name != NULL);
+        ovidx = dictionary[i].ov;
+        return dictionary[i].name;
+    }
     if (word == 0x0) return "";
 
     if(canFail == 0)
@@ -169,16 +282,20 @@ const char* FindWord(int word, int ovidx)
 int FindWordByName(char* s, int n)
 {
     if (n == 0) return 0;
-    int ovidx = GetOverlayIndex(Read16(0x55a5), nullptr); // "OV#"
+    int ovidx = GetCurrentOverlayIndex();
 
-    std::string temp(s, n);
+    const DictionaryIndex& index = GetDictionaryIndex();
+    uint32_t hash = HashName(s, n);
+    auto it = std::lower_bound(index.names.begin(), index.names.end(), hash,
+        [](const NameIndexEntry& e, uint32_t h) { return e.hash < h; });
 
-    int i = 0;
-    do
+    for (; it != index.names.end() && it->hash == hash; ++it)
     {
-        if ((dictionary[i].ov != ovidx) && (dictionary[i].ov != -1)) continue;
-        if (std::equal(temp.begin(), temp.end(), dictionary[i].name, [](char a, char b) { return tolower(a) == tolower(b); })) return dictionary[i].word;
-    } while(dictionary[++i].name != NULL);
+        const SF_WORD& entry = dictionary[it->index];
+        if ((entry.ov != ovidx) && (entry.ov != -1)) continue;
+        if (strlen(entry.name) != (size_t)n) continue;
+        if (std::equal(s, s + n, entry.name, [](char a, char b) { return tolower(a) == tolower(b); })) return entry.word;
+    }
     //fprintf(stderr, "Error: Cannot find string %s\n", s.c_str());
     return 0;
 }
@@ -4,6 +4,7 @@
 #include "dictionary.h"
 
 int GetOverlayIndex(int address, const char** overlayName);
+int GetCurrentOverlayIndex();
 int FindClosestWord(int si, int ovidx);
 const char* GetOverlayName(int word, int ovidx);
 const char* GetOverlayName(int ovidx);
@@ -22,7 +22,7 @@ DEFINE_LOG_CATEGORY_STATIC(LogStarflightFract, Log, All);
 // Simple wrapper to redirect printf-style logging to UE
 static void SF_Log(const char* Format, ...)
 {
-	static char Buffer[4096];
+	static thread_local char Buffer[4096];
 	va_list Args;
 	va_start(Args, Format);
 	vsnprintf(Buffer, sizeof(Buffer), Format, Args);
@@ -36,13 +36,17 @@ static void SF_Log(const char* Format, ...)
 
 #include "starsystem.h"
 
+#ifdef _WIN32
 extern "C" {
     __declspec(dllimport) void __stdcall OutputDebugStringA(const char* lpOutputString);
 }
+#else
+static void OutputDebugStringA(const char* lpOutputString) { fputs(lpOutputString, stderr); }
+#endif
 
 // External declarations for memory access
-extern unsigned char* currentMemory;
-extern uint16_t* RandomSeed;
+extern thread_local unsigned char* currentMemory;
+extern thread_local uint16_t* RandomSeed;
 
 #if defined(__GNUC__)
     #define FORCE_INLINE __attribute__((always_inline)) inline
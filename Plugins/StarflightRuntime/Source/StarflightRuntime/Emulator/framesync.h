@@ -0,0 +1,47 @@
+#ifndef FRAMESYNC_H
+#define FRAMESYNC_H
+
+#include <stdint.h>
+#include <chrono>
+#include <mutex>
+
+enum class OrbitState {
+    None,
+    Insertion,
+    Landing,
+    Takeoff,
+    Holding,
+    Orbit
+};
+
+struct FrameSync {
+    bool inDrawAuxSys = false;
+    bool inDrawStarMap = false;
+    bool maneuvering = false;
+    uint32_t gameContext = 0;
+    bool shouldSave = false;
+    bool inCombatKey = false;
+    bool inCombatRender = false;
+    bool inDrawShipButton = false;
+    bool inSmallLogo = false;
+    float currentPlanetMass = 0.0f;
+    float currentPlanetSphereSize = 0.0f;
+    bool pastHimus = false;
+    bool inGameOps = false;
+    bool inNebula = false;
+    bool inFlux = false;
+    uint32_t currentPlanet = 0;
+    uint32_t completedFrames = 0;
+    // Last RunBitPixel tag seen (from CSCR>EGA or .EGARUNBIT paths)
+    uint16_t lastRunBitTag = 0;
+    OrbitState currentOrbitState = OrbitState::None;
+    std::chrono::steady_clock::time_point maneuveringStartTime;
+    std::chrono::steady_clock::time_point maneuveringEndTime;
+    int32_t gameTickTimer;
+    std::mutex mutex;
+};
+
+// The FrameSync of the EmulatorContext bound to this thread, see context.h
+extern thread_local FrameSync* frameSync;
+
+#endif
@@ -4,15 +4,23 @@
 #include "graphics.h"
 #include "../Public/StarflightBridge.h"
 #include "cpu/cpu.h"
+#include "call.h"
+#include "context.h"
 #include "font_cp437.h"
+#include "pixelconvert.h"
 #include "tables.h"
 #include <cassert>
+#include <cstdio>
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <cstring>
 #include <algorithm>
+#include <array>
 
 // EGA color palette in 0x00RRGGBB format (matches native)
 // Made non-static so call.cpp can access it
@@ -35,20 +43,121 @@ uint32_t colortable[16] = {
     0x00FFFFFF  // 15: White
 };
 
-bool graphicsIsShutdown = false;
-
 // Global emulation control flag used by call.cpp
 std::atomic<bool> stopEmulationThread{false};
 
-// Graphics state
-static std::atomic<int> s_graphicsMode{0}; // 0 = text, 1 = graphics
-static std::mutex s_framebufferMutex;
-static std::vector<uint8_t> s_framebuffer;
-static std::vector<uint32_t> graphicsPixels; // 0x00RRGGBB like native
-static std::vector<Rotoscope> rotoscopePixels;
-static std::mutex rotoscopePixelMutex;
-static int s_cursorX = 0;
-static int s_cursorY = 0;
+// Display page as handed from the emulator thread to GraphicsUpdate()
+struct GraphicsFrame
+{
+    int mode = 0;
+    std::vector<uint8_t> pixels;   // 160x200 EGA colors
+    std::vector<uint8_t> content;  // Rotoscope::content per pixel
+    std::vector<uint8_t> text;     // 80x25 character/attribute pairs
+    std::vector<uint8_t> rows;     // display rows changed since the frame the presenter has
+    std::vector<uint8_t> textRows; // text rows changed since the frame the presenter has
+    uint64_t publishTime = 0;      // steady_clock ns when GraphicsPublishFrame() handed it over
+};
+
+// Per-primitive part of a Rotoscope: what the line, glyph, run-bit image or
+// pic was. Pixels of one primitive share an entry of GraphicsState::rotoMetaTable.
+// No padding, so entries can be hashed and compared as bytes.
+struct RotoscopeMeta
+{
+    int16_t bltW, bltH;
+    int32_t lineX0, lineX1, lineY0, lineY1, lineTotal;
+    uint32_t runBitTag, picID;
+    uint16_t fontNum;
+    char character;
+    uint8_t xormode;
+};
+static_assert(sizeof(RotoscopeMeta) == 36, "RotoscopeMeta must not have padding");
+
+// Graphics state, one per EmulatorContext
+//
+// The backing store holds EGA color indices. ARGB is only made when a frame
+// is presented, through colortable, so peeks and blends work on bytes.
+//
+// The rotoscope is kept as planes: per pixel a content byte, the fg and bg
+// colors, the position inside the primitive (blt_x/blt_y, or lineData.n for
+// lines) and an index into rotoMetaTable. That is 9 bytes a pixel instead of
+// a Rotoscope, and drawing a pixel is a few stores. LoadRotoscope() gives
+// back every field StorePixel() was handed.
+//
+// The emulator thread is the only writer of the pixel and rotoscope planes
+// and takes no locks to draw. When the game finishes a frame (retrace wait,
+// page flip, display move, or an idle key poll) GraphicsPublishFrame() copies
+// the display page into the back slot of a triple buffer, swaps it into the
+// middle slot and wakes GraphicsWaitFrame(). The presenter swaps the middle
+// slot out as its front, so it never sees a half drawn page.
+//
+// Writers mark the display page rows they touch in dirtyRows. A frame is
+// only published when rows, the text page or the mode changed, and it
+// carries the changed rows so the presenter converts and emits only those.
+struct GraphicsState
+{
+    std::atomic<bool> isShutdown{false};
+    std::atomic<int> graphicsMode{0}; // 0 = text, 1 = graphics
+    std::vector<uint8_t> graphicsIndex; // EGA color per pixel, like native
+    std::vector<uint8_t> rotoContent;
+    std::vector<uint16_t> rotoColors;   // fgColor | bgColor << 8
+    std::vector<uint32_t> rotoPosition; // (uint16_t)blt_x | (uint16_t)blt_y << 16, lineData.n for LinePixel
+    std::vector<uint16_t> rotoMeta;
+    std::vector<RotoscopeMeta> rotoMetaTable; // entry 0 is all zero
+    std::unordered_map<uint64_t, uint16_t> rotoMetaLookup; // hash -> entry
+    uint16_t lastMeta = 0;
+    int cursorX = 0;
+    int cursorY = 0;
+
+    static constexpr int FreshFrame = 4;
+    GraphicsFrame frames[3];
+    int backFrame = 0;                 // emulator thread only
+    std::atomic<int> middleFrame{1};   // slot index, | FreshFrame once published
+    int frontFrame = 2;                // presenter only
+    std::mutex frameMutex;             // only guards frameReady waits
+    std::condition_variable frameReady;
+    std::atomic<bool> fullFrameRequested{false}; // a new frame sink needs the whole screen, see GraphicsRequestFullFrame()
+
+    std::vector<uint8_t> dirtyRows;    // display page rows drawn since the last publish
+    bool anyDirty = false;
+    std::vector<uint8_t> carryRows;    // rows and text rows of the last published frame
+    std::vector<uint8_t> carryText;
+    std::vector<uint8_t> textDirtyRows; // text page rows written since the last publish, see GraphicsTextWritten()
+    bool anyTextDirty = false;
+    bool textUnknown = false;          // the 8086 core ran, see GraphicsTextUnknown()
+    std::vector<uint8_t> publishedText;
+    int publishedMode = -1;
+
+    std::mutex framebufferMutex;
+    std::vector<uint8_t> framebuffer;
+    int emittedWidth = 0;              // size of the last frame emitted from framebuffer, 0 before the first
+    int emittedHeight = 0;
+    uint64_t emittedPublishTime = 0;   // publishTime of the frame GraphicsUpdate() took last
+    std::vector<uint8_t> textShadow;   // char/attr pairs the text framebuffer shows
+    bool textShadowValid = false;
+    std::array<uint32_t, 16> textShadowColors = {}; // colortable the text framebuffer was drawn with
+    std::unordered_map<uint64_t, std::array<uint32_t, 64>> glyphCache; // char | fg << 8 | bg << 32 (BGR) -> 8x8 BGRA
+    std::vector<uint8_t> rotoDebug;
+
+    std::vector<uint16_t> keyQueue;
+    std::mutex keyMutex;
+    FILE* keyRecording = nullptr;
+};
+
+GraphicsState* GraphicsCreateState()
+{
+    return new GraphicsState();
+}
+
+void GraphicsDestroyState(GraphicsState* state)
+{
+    if (state && state->keyRecording) fclose(state->keyRecording);
+    delete state;
+}
+
+static inline GraphicsState& CurrentGraphics()
+{
+    return *EmulatorContext::Current().graphics;
+}
 
 // Dimensions
 constexpr int TEXT_WIDTH = 80;
@@ -57,6 +166,7 @@ constexpr int TEXT_CHAR_WIDTH = 8;
 constexpr int TEXT_CHAR_HEIGHT = 8;
 constexpr int GRAPHICS_MODE_WIDTH = 160;   // Match native
 constexpr int GRAPHICS_MODE_HEIGHT = 200;  // Match native
+constexpr int GRAPHICS_PIXEL_WIDTH = 4;    // Emitted pixels per EGA pixel: 160 -> 640
 constexpr int GRAPHICS_PAGE_COUNT = 2;
 constexpr int GRAPHICS_MEMORY_ALLOC = 65536; // Matches native backing store
 
@@ -64,6 +174,197 @@ constexpr int GRAPHICS_MEMORY_ALLOC = 65536; // Matches native backing store
 constexpr uint32_t TEXT_SEGMENT = 0xB800;
 constexpr uint32_t GRAPHICS_SEGMENT = 0xA000;
 
+// ------------------------------------------------
+// Rotoscope planes
+// ------------------------------------------------
+
+static uint64_t HashMeta(const RotoscopeMeta& meta)
+{
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ull;
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&meta);
+    for (size_t i = 0; i < sizeof(meta); ++i)
+    {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static void ResetMeta(GraphicsState& gfx)
+{
+    gfx.rotoMetaTable.assign(1, RotoscopeMeta{});
+    gfx.rotoMetaLookup.clear();
+    gfx.rotoMetaLookup[HashMeta(gfx.rotoMetaTable[0])] = 0;
+    gfx.lastMeta = 0;
+}
+
+// Drops table entries no pixel refers to any more
+static void CompactMeta(GraphicsState& gfx)
+{
+    std::vector<RotoscopeMeta> table(1, gfx.rotoMetaTable[0]);
+    std::vector<uint32_t> remap(gfx.rotoMetaTable.size(), UINT32_MAX);
+    remap[0] = 0;
+
+    for (uint16_t& index : gfx.rotoMeta)
+    {
+        if (remap[index] == UINT32_MAX)
+        {
+            remap[index] = (uint32_t)table.size();
+            table.push_back(gfx.rotoMetaTable[index]);
+        }
+        index = (uint16_t)remap[index];
+    }
+
+    gfx.rotoMetaTable.swap(table);
+    gfx.rotoMetaLookup.clear();
+    for (size_t i = 0; i < gfx.rotoMetaTable.size(); ++i)
+    {
+        gfx.rotoMetaLookup[HashMeta(gfx.rotoMetaTable[i])] = (uint16_t)i;
+    }
+    gfx.lastMeta = 0;
+}
+
+static uint16_t InternMeta(GraphicsState& gfx, const RotoscopeMeta& meta)
+{
+    // Consecutive pixels nearly always come from the same primitive
+    if (memcmp(&meta, &gfx.rotoMetaTable[gfx.lastMeta], sizeof(meta)) == 0)
+    {
+        return gfx.lastMeta;
+    }
+
+    const uint64_t hash = HashMeta(meta);
+    auto it = gfx.rotoMetaLookup.find(hash);
+    if (it != gfx.rotoMetaLookup.end() && memcmp(&meta, &gfx.rotoMetaTable[it->second], sizeof(meta)) == 0)
+    {
+        return gfx.lastMeta = it->second;
+    }
+
+    if (gfx.rotoMetaTable.size() > UINT16_MAX)
+    {
+        CompactMeta(gfx);
+        if (gfx.rotoMetaTable.size() > UINT16_MAX)
+        {
+            return 0;
+        }
+    }
+
+    const uint16_t index = (uint16_t)gfx.rotoMetaTable.size();
+    gfx.rotoMetaTable.push_back(meta);
+    gfx.rotoMetaLookup[hash] = index;
+    return gfx.lastMeta = index;
+}
+
+static uint16_t InternMeta(GraphicsState& gfx, const Rotoscope& pc)
+{
+    return InternMeta(gfx, RotoscopeMeta{
+        pc.blt_w, pc.blt_h,
+        pc.lineData.x0, pc.lineData.x1, pc.lineData.y0, pc.lineData.y1, pc.lineData.total,
+        pc.runBitData.tag, pc.picData.picID,
+        pc.textData.fontNum, pc.textData.character, pc.textData.xormode });
+}
+
+static inline uint16_t PackColors(uint8_t fg, uint8_t bg)
+{
+    return (uint16_t)(fg | bg << 8);
+}
+
+static inline uint16_t PackColors(const Rotoscope& pc)
+{
+    return PackColors(pc.fgColor, pc.bgColor);
+}
+
+static inline uint32_t PackPosition(int bltX, int bltY)
+{
+    return (uint16_t)bltX | (uint32_t)(uint16_t)bltY << 16;
+}
+
+static inline uint32_t PackPosition(const Rotoscope& pc)
+{
+    return pc.content == LinePixel ? (uint32_t)pc.lineData.n : PackPosition(pc.blt_x, pc.blt_y);
+}
+
+// Marks the display page rows of count pixels from idx for the next publish.
+// The display page is at 0xA000, so its pixels are the first 160x200.
+static inline void MarkDirty(GraphicsState& gfx, uint32_t idx, uint32_t count = 1)
+{
+    constexpr uint32_t displayPixels = GRAPHICS_MODE_WIDTH * GRAPHICS_MODE_HEIGHT;
+    if (idx >= displayPixels || count == 0)
+    {
+        return;
+    }
+    const uint32_t first = idx / GRAPHICS_MODE_WIDTH;
+    const uint32_t last = (std::min(idx + count, displayPixels) - 1) / GRAPHICS_MODE_WIDTH;
+    memset(&gfx.dirtyRows[first], 1, last - first + 1);
+    gfx.anyDirty = true;
+}
+
+// Text page counterpart of MarkDirty, offset and count in bytes from B800:0000
+static inline void MarkTextDirty(GraphicsState& gfx, uint32_t offset, uint32_t count)
+{
+    constexpr uint32_t rowBytes = TEXT_WIDTH * 2;
+    constexpr uint32_t pageBytes = rowBytes * TEXT_HEIGHT;
+    if (offset >= pageBytes || count == 0)
+    {
+        return;
+    }
+    const uint32_t first = offset / rowBytes;
+    const uint32_t last = (std::min(offset + count, pageBytes) - 1) / rowBytes;
+    memset(&gfx.textDirtyRows[first], 1, last - first + 1);
+    gfx.anyTextDirty = true;
+}
+
+static inline void StorePixel(GraphicsState& gfx, uint32_t idx, uint8_t egaColor, const Rotoscope& pc)
+{
+    MarkDirty(gfx, idx);
+    gfx.graphicsIndex[idx] = egaColor & 0xF;
+    gfx.rotoContent[idx] = (uint8_t)pc.content;
+    gfx.rotoColors[idx] = PackColors(pc);
+    gfx.rotoPosition[idx] = PackPosition(pc);
+    gfx.rotoMeta[idx] = InternMeta(gfx, pc);
+}
+
+static inline void ClearRotoscope(GraphicsState& gfx, uint32_t idx, uint32_t count)
+{
+    memset(&gfx.rotoContent[idx], ClearPixel, count);
+    memset(&gfx.rotoColors[idx], 0, count * sizeof(uint16_t));
+    memset(&gfx.rotoPosition[idx], 0, count * sizeof(uint32_t));
+    memset(&gfx.rotoMeta[idx], 0, count * sizeof(uint16_t));
+}
+
+static void LoadRotoscope(const GraphicsState& gfx, uint32_t idx, Rotoscope& pc)
+{
+    const RotoscopeMeta& meta = gfx.rotoMetaTable[gfx.rotoMeta[idx]];
+    const uint16_t colors = gfx.rotoColors[idx];
+    const uint32_t position = gfx.rotoPosition[idx];
+
+    pc = Rotoscope((PixelContents)gfx.rotoContent[idx]);
+    pc.EGAcolor = gfx.graphicsIndex[idx];
+    pc.fgColor = (uint8_t)colors;
+    pc.bgColor = (uint8_t)(colors >> 8);
+    pc.argb = colortable[pc.EGAcolor];
+    if (pc.content == LinePixel)
+    {
+        pc.lineData.n = (int)position;
+    }
+    else
+    {
+        pc.blt_x = (int16_t)position;
+        pc.blt_y = (int16_t)(position >> 16);
+    }
+    pc.blt_w = meta.bltW;
+    pc.blt_h = meta.bltH;
+    pc.lineData.x0 = meta.lineX0;
+    pc.lineData.x1 = meta.lineX1;
+    pc.lineData.y0 = meta.lineY0;
+    pc.lineData.y1 = meta.lineY1;
+    pc.lineData.total = meta.lineTotal;
+    pc.textData.character = meta.character;
+    pc.textData.fontNum = meta.fontNum;
+    pc.textData.xormode = meta.xormode;
+    pc.runBitData.tag = meta.runBitTag;
+    pc.picData.picID = meta.picID;
+}
+
 // Debug: color mapping per PixelContents for rotoscope visualization (BGRA)
 static inline uint32_t RotoDebugBGRA(uint8_t content)
 {
@@ -87,37 +388,106 @@ static inline uint32_t RotoDebugBGRA(uint8_t content)
     }
 }
 
-// Build and emit the 160x200 rotoscope debug buffer once per GraphicsUpdate
-static void EmitRotoscopeDebug()
+// EGA color as a BGRA pixel in memory order
+static inline uint32_t ColorBGRA(int ega)
+{
+    const uint32_t color = colortable[ega & 0xF];
+    const uint8_t bgra[4] = { (uint8_t)color, (uint8_t)(color >> 8), (uint8_t)(color >> 16), 0xFF };
+    uint32_t pixel;
+    memcpy(&pixel, bgra, sizeof(bgra));
+    return pixel;
+}
+
+// 8x8 CP437 glyph of a text cell expanded to BGRA, made on first use. Keyed by the resolved
+// colors, not the attribute, so a glyph is never drawn with a stale colortable entry
+static const std::array<uint32_t, 64>& TextGlyph(GraphicsState& gfx, uint8_t ch, uint8_t attr)
+{
+    const uint32_t fg = ColorBGRA(attr & 0x0F);
+    const uint32_t bg = ColorBGRA(attr >> 4);
+    const uint64_t key = ch | (uint64_t)(fg & 0xFFFFFF) << 8 | (uint64_t)(bg & 0xFFFFFF) << 32;
+    auto [it, inserted] = gfx.glyphCache.try_emplace(key);
+    if (inserted)
+    {
+        for (int cy = 0; cy < TEXT_CHAR_HEIGHT; ++cy)
+        {
+            const uint8_t fontRow = vgafont8[ch * 8 + cy];
+            for (int cx = 0; cx < TEXT_CHAR_WIDTH; ++cx)
+            {
+                it->second[cy * TEXT_CHAR_WIDTH + cx] = (fontRow & (0x80 >> cx)) ? fg : bg;
+            }
+        }
+    }
+    return it->second;
+}
+
+// Update the changed rows of the 160x200 rotoscope debug buffer and emit it
+static void EmitRotoscopeDebug(GraphicsState& gfx, const GraphicsFrame& frame)
 {
-    static std::vector<uint8_t> s_rotoDebug;
-    s_rotoDebug.resize(GRAPHICS_MODE_WIDTH * GRAPHICS_MODE_HEIGHT * 4);
-    std::lock_guard<std::mutex> rg(rotoscopePixelMutex);
+    if (gfx.rotoDebug.size() != GRAPHICS_MODE_WIDTH * GRAPHICS_MODE_HEIGHT * 4)
+    {
+        gfx.rotoDebug.assign(GRAPHICS_MODE_WIDTH * GRAPHICS_MODE_HEIGHT * 4, 0);
+    }
+    bool changed = false;
     for (int y = 0; y < GRAPHICS_MODE_HEIGHT; ++y)
     {
+        if (!frame.rows[y]) continue;
+        changed = true;
         for (int x = 0; x < GRAPHICS_MODE_WIDTH; ++x)
         {
-            const Rotoscope& rs = rotoscopePixels[y * GRAPHICS_MODE_WIDTH + x];
-            const uint32_t bgra = RotoDebugBGRA(static_cast<uint8_t>(rs.content));
+            const uint32_t bgra = RotoDebugBGRA(frame.content[y * GRAPHICS_MODE_WIDTH + x]);
             const int o = (y * GRAPHICS_MODE_WIDTH + x) * 4;
-            s_rotoDebug[o + 0] = (uint8_t)((bgra >> 0) & 0xFF);
-            s_rotoDebug[o + 1] = (uint8_t)((bgra >> 8) & 0xFF);
-            s_rotoDebug[o + 2] = (uint8_t)((bgra >> 16) & 0xFF);
-            s_rotoDebug[o + 3] = (uint8_t)((bgra >> 24) & 0xFF);
+            gfx.rotoDebug[o + 0] = (uint8_t)((bgra >> 0) & 0xFF);
+            gfx.rotoDebug[o + 1] = (uint8_t)((bgra >> 8) & 0xFF);
+            gfx.rotoDebug[o + 2] = (uint8_t)((bgra >> 16) & 0xFF);
+            gfx.rotoDebug[o + 3] = (uint8_t)((bgra >> 24) & 0xFF);
         }
     }
-    EmitRotoscope(s_rotoDebug.data(), GRAPHICS_MODE_WIDTH, GRAPHICS_MODE_HEIGHT, GRAPHICS_MODE_WIDTH * 4);
+    if (changed)
+    {
+        EmitRotoscope(gfx.rotoDebug.data(), GRAPHICS_MODE_WIDTH, GRAPHICS_MODE_HEIGHT, GRAPHICS_MODE_WIDTH * 4);
+    }
 }
 
 void GraphicsInit()
 {
-    s_framebuffer.resize(TEXT_WIDTH * TEXT_CHAR_WIDTH * TEXT_HEIGHT * TEXT_CHAR_HEIGHT * 4, 0);
-    graphicsIsShutdown = false;
-    s_graphicsMode.store(0); // Start in text mode (80x25), game will switch to graphics mode
-    s_cursorX = 0;
-    s_cursorY = 0;
-    graphicsPixels.assign(GRAPHICS_MEMORY_ALLOC, 0);
-    rotoscopePixels.assign(GRAPHICS_MEMORY_ALLOC, Rotoscope{});
+    GraphicsState& gfx = CurrentGraphics();
+    gfx.framebuffer.resize(TEXT_WIDTH * TEXT_CHAR_WIDTH * TEXT_HEIGHT * TEXT_CHAR_HEIGHT * 4, 0);
+    gfx.emittedWidth = 0;
+    gfx.emittedHeight = 0;
+    gfx.isShutdown = false;
+    gfx.graphicsMode.store(0); // Start in text mode (80x25), game will switch to graphics mode
+    gfx.cursorX = 0;
+    gfx.cursorY = 0;
+    gfx.graphicsIndex.assign(GRAPHICS_MEMORY_ALLOC, 0);
+    gfx.rotoContent.assign(GRAPHICS_MEMORY_ALLOC, ClearPixel);
+    gfx.rotoColors.assign(GRAPHICS_MEMORY_ALLOC, 0);
+    gfx.rotoPosition.assign(GRAPHICS_MEMORY_ALLOC, 0);
+    gfx.rotoMeta.assign(GRAPHICS_MEMORY_ALLOC, 0);
+    ResetMeta(gfx);
+
+    for (GraphicsFrame& frame : gfx.frames)
+    {
+        frame.mode = 0;
+        frame.pixels.assign(GRAPHICS_MODE_WIDTH * GRAPHICS_MODE_HEIGHT, 0);
+        frame.content.assign(GRAPHICS_MODE_WIDTH * GRAPHICS_MODE_HEIGHT, ClearPixel);
+        frame.text.assign(TEXT_WIDTH * TEXT_HEIGHT * 2, 0);
+        frame.rows.assign(GRAPHICS_MODE_HEIGHT, 0);
+        frame.textRows.assign(TEXT_HEIGHT, 0);
+    }
+    gfx.dirtyRows.assign(GRAPHICS_MODE_HEIGHT, 0);
+    gfx.anyDirty = false;
+    gfx.carryRows.assign(GRAPHICS_MODE_HEIGHT, 0);
+    gfx.carryText.assign(TEXT_HEIGHT, 0);
+    gfx.textDirtyRows.assign(TEXT_HEIGHT, 0);
+    gfx.anyTextDirty = false;
+    gfx.textUnknown = false;
+    gfx.publishedText.assign(TEXT_WIDTH * TEXT_HEIGHT * 2, 0);
+    gfx.publishedMode = -1; // first publish sends everything
+    gfx.textShadow.assign(TEXT_WIDTH * TEXT_HEIGHT * 2, 0);
+    gfx.textShadowValid = false;
+    gfx.backFrame = 0;
+    gfx.middleFrame.store(1);
+    gfx.frontFrame = 2;
     
     // Clear text memory (0xB800) to black background, light gray foreground
     uint32_t textMemBase = ComputeAddress(TEXT_SEGMENT, 0);
@@ -129,100 +499,286 @@ void GraphicsInit()
 
 void GraphicsQuit()
 {
-    graphicsIsShutdown = true;
+    GraphicsState& gfx = CurrentGraphics();
+    {
+        std::lock_guard<std::mutex> lock(gfx.frameMutex);
+        gfx.isShutdown = true;
+    }
+    gfx.frameReady.notify_all();
+}
+
+void GraphicsWaitFrame()
+{
+    GraphicsState& gfx = CurrentGraphics();
+    std::unique_lock<std::mutex> lock(gfx.frameMutex);
+    gfx.frameReady.wait(lock, [&gfx]()
+    {
+        return gfx.isShutdown || gfx.fullFrameRequested.load(std::memory_order_relaxed) ||
+            (gfx.middleFrame.load(std::memory_order_acquire) & GraphicsState::FreshFrame) != 0;
+    });
+}
+
+void GraphicsRequestFullFrame()
+{
+    GraphicsState& gfx = CurrentGraphics();
+    {
+        std::lock_guard<std::mutex> lock(gfx.frameMutex);
+        gfx.fullFrameRequested = true;
+    }
+    gfx.frameReady.notify_one();
+}
+
+void GraphicsTextWritten(uint32_t address, uint32_t count)
+{
+    const uint32_t base = ComputeAddress(TEXT_SEGMENT, 0);
+    if (address + count <= base)
+    {
+        return;
+    }
+    GraphicsState& gfx = CurrentGraphics();
+    if (address < base)
+    {
+        count -= base - address;
+        address = base;
+    }
+    MarkTextDirty(gfx, address - base, count);
+}
+
+void GraphicsTextUnknown()
+{
+    CurrentGraphics().textUnknown = true;
+}
+
+uint64_t GraphicsEmittedPublishTime()
+{
+    return CurrentGraphics().emittedPublishTime;
+}
+
+void GraphicsPublishFrame()
+{
+    GraphicsState& gfx = CurrentGraphics();
+
+    // Nothing new on screen: publish nothing and wake nobody
+    const int mode = gfx.graphicsMode.load(std::memory_order_relaxed);
+    const uint8_t* text = &m[ComputeAddress(TEXT_SEGMENT, 0)];
+    const size_t textBytes = TEXT_WIDTH * TEXT_HEIGHT * 2;
+    const size_t rowBytes = TEXT_WIDTH * 2;
+    const bool modeChanged = mode != gfx.publishedMode;
+
+    // Text rows are known from the writes, except after 8086 code, which is
+    // checked against the published page. Only while the text page is shown.
+    if (mode == 0 && !modeChanged && gfx.textUnknown)
+    {
+        for (int row = 0; row < TEXT_HEIGHT; ++row)
+        {
+            if (!gfx.textDirtyRows[row] && memcmp(text + row * rowBytes, &gfx.publishedText[row * rowBytes], rowBytes) != 0)
+            {
+                MarkTextDirty(gfx, row * rowBytes, rowBytes);
+            }
+        }
+        gfx.textUnknown = false;
+    }
+    const bool textChanged = mode == 0 && !modeChanged && gfx.anyTextDirty;
+    if (!modeChanged && !textChanged && !gfx.anyDirty)
+        return;
+
+    GraphicsFrame& frame = gfx.frames[gfx.backFrame];
+    frame.mode = mode;
+
+    // A frame the presenter has not taken yet is replaced, so its rows are
+    // still owed. Once taken, the middle slot stays stale until we publish.
+    if (gfx.middleFrame.load(std::memory_order_acquire) & GraphicsState::FreshFrame)
+    {
+        frame.rows = gfx.carryRows;
+        frame.textRows = gfx.carryText;
+    }
+    else
+    {
+        std::fill(frame.rows.begin(), frame.rows.end(), 0);
+        std::fill(frame.textRows.begin(), frame.textRows.end(), 0);
+    }
+
+    if (modeChanged)
+    {
+        std::fill(frame.rows.begin(), frame.rows.end(), 1);
+        std::fill(frame.textRows.begin(), frame.textRows.end(), 1);
+    }
+    for (int row = 0; row < GRAPHICS_MODE_HEIGHT; ++row)
+    {
+        frame.rows[row] |= gfx.dirtyRows[row];
+    }
+    if (textChanged)
+    {
+        for (int row = 0; row < TEXT_HEIGHT; ++row)
+        {
+            frame.textRows[row] |= gfx.textDirtyRows[row];
+        }
+    }
+
+    // Display page base is 0xA000 -> offset index 0 in our arrays
+    const int count = GRAPHICS_MODE_WIDTH * GRAPHICS_MODE_HEIGHT;
+    memcpy(frame.pixels.data(), gfx.graphicsIndex.data(), count);
+    memcpy(frame.content.data(), gfx.rotoContent.data(), count);
+    memcpy(frame.text.data(), text, textBytes);
+    frame.publishTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    std::fill(gfx.dirtyRows.begin(), gfx.dirtyRows.end(), 0);
+    gfx.anyDirty = false;
+    std::fill(gfx.textDirtyRows.begin(), gfx.textDirtyRows.end(), 0);
+    gfx.anyTextDirty = false;
+    gfx.textUnknown = false;
+    gfx.carryRows = frame.rows;
+    gfx.carryText = frame.textRows;
+    memcpy(gfx.publishedText.data(), text, textBytes);
+    gfx.publishedMode = mode;
+
+    gfx.backFrame = gfx.middleFrame.exchange(gfx.backFrame | GraphicsState::FreshFrame, std::memory_order_acq_rel) & ~GraphicsState::FreshFrame;
+
+    // Pass through the mutex so a presenter between its check and its wait
+    // cannot miss the wakeup
+    {
+        std::lock_guard<std::mutex> lock(gfx.frameMutex);
+    }
+    gfx.frameReady.notify_one();
 }
 
 void GraphicsUpdate()
 {
-    if (graphicsIsShutdown) return;
+    GraphicsState& gfx = CurrentGraphics();
+    if (gfx.isShutdown) return;
 
-    std::lock_guard<std::mutex> lock(s_framebufferMutex);
+    std::lock_guard<std::mutex> lock(gfx.framebufferMutex);
+
+    // A full frame goes out without dirty rects, so every sink replaces its copy
+    const bool fullFrame = gfx.fullFrameRequested.exchange(false);
+
+    // Take the newest published frame. Without one the screen is unchanged
+    // and only a full frame request sends the framebuffer again.
+    if (!(gfx.middleFrame.load(std::memory_order_relaxed) & GraphicsState::FreshFrame))
+    {
+        if (fullFrame && gfx.emittedWidth > 0)
+        {
+            EmitFrame(gfx.framebuffer.data(), gfx.emittedWidth, gfx.emittedHeight, gfx.emittedWidth * 4, nullptr, 0);
+        }
+        return;
+    }
+    gfx.frontFrame = gfx.middleFrame.exchange(gfx.frontFrame, std::memory_order_acq_rel) & ~GraphicsState::FreshFrame;
+    const GraphicsFrame& frame = gfx.frames[gfx.frontFrame];
+    gfx.emittedPublishTime = frame.publishTime;
+
+    int mode = frame.mode;
+
+    // Runs of changed rows, in framebuffer pixels
+    FStarflightDirtyRect dirty[GRAPHICS_MODE_HEIGHT];
+    int dirtyCount = 0;
+    auto addRows = [&](int y, int h, int width)
+    {
+        if (dirtyCount > 0 && dirty[dirtyCount - 1].Y + dirty[dirtyCount - 1].Height == y)
+        {
+            dirty[dirtyCount - 1].Height += h;
+        }
+        else
+        {
+            dirty[dirtyCount++] = { 0, y, width, h };
+        }
+    };
 
-    int mode = s_graphicsMode.load();
-    
     if (mode == 0) {
         // Text mode: 80x25 characters, read from segment 0xB800
         // Each character is 2 bytes: [char, attribute]
         int fbWidth = TEXT_WIDTH * TEXT_CHAR_WIDTH;
         int fbHeight = TEXT_HEIGHT * TEXT_CHAR_HEIGHT;
         
-        if (s_framebuffer.size() != fbWidth * fbHeight * 4) {
-            s_framebuffer.resize(fbWidth * fbHeight * 4);
+        if (gfx.framebuffer.size() != fbWidth * fbHeight * 4) {
+            gfx.framebuffer.resize(fbWidth * fbHeight * 4);
         }
 
-        uint32_t textMemBase = ComputeAddress(TEXT_SEGMENT, 0);
-        
+        // A colortable write changes the colors of every cell
+        if (memcmp(gfx.textShadowColors.data(), colortable, sizeof(colortable)) != 0) {
+            memcpy(gfx.textShadowColors.data(), colortable, sizeof(colortable));
+            gfx.textShadowValid = false;
+        }
+
+        // Only cells that differ from what the framebuffer shows are redrawn
+        uint32_t* out = reinterpret_cast<uint32_t*>(gfx.framebuffer.data());
         for (int row = 0; row < TEXT_HEIGHT; ++row) {
+            if (!frame.textRows[row] && gfx.textShadowValid) continue;
+
+            bool rowChanged = false;
             for (int col = 0; col < TEXT_WIDTH; ++col) {
-                uint32_t offset = textMemBase + (row * TEXT_WIDTH + col) * 2;
-                uint8_t ch = m[offset];
-                uint8_t attr = m[offset + 1];
-                
-                uint8_t fgColor = attr & 0x0F;
-                uint8_t bgColor = (attr >> 4) & 0x0F;
-                
-                // Render 8x8 character using CP437 font
+                uint32_t offset = (row * TEXT_WIDTH + col) * 2;
+                uint8_t ch = frame.text[offset];
+                uint8_t attr = frame.text[offset + 1];
+                if (gfx.textShadowValid && gfx.textShadow[offset] == ch && gfx.textShadow[offset + 1] == attr) continue;
+                gfx.textShadow[offset] = ch;
+                gfx.textShadow[offset + 1] = attr;
+                rowChanged = true;
+
+                const std::array<uint32_t, 64>& glyph = TextGlyph(gfx, ch, attr);
+                uint32_t* cell = out + row * TEXT_CHAR_HEIGHT * fbWidth + col * TEXT_CHAR_WIDTH;
                 for (int cy = 0; cy < TEXT_CHAR_HEIGHT; ++cy) {
-                    int fontOffset = ch * 8 + cy;
-                    uint8_t fontRow = vgafont8[fontOffset];
-                    
-                    for (int cx = 0; cx < TEXT_CHAR_WIDTH; ++cx) {
-                        bool pixelOn = (fontRow & (1 << (7 - cx))) != 0;
-                        uint32_t color = pixelOn ? colortable[fgColor] : colortable[bgColor];
-                        
-                        int px = col * TEXT_CHAR_WIDTH + cx;
-                        int py = row * TEXT_CHAR_HEIGHT + cy;
-                        int idx = (py * fbWidth + px) * 4;
-                        
-                        s_framebuffer[idx + 0] = (color >> 0) & 0xFF;  // B
-                        s_framebuffer[idx + 1] = (color >> 8) & 0xFF;  // G
-                        s_framebuffer[idx + 2] = (color >> 16) & 0xFF; // R
-                        s_framebuffer[idx + 3] = 0xFF;                  // A
-                    }
+                    memcpy(cell + cy * fbWidth, &glyph[cy * TEXT_CHAR_WIDTH], TEXT_CHAR_WIDTH * sizeof(uint32_t));
                 }
             }
+            if (rowChanged) addRows(row * TEXT_CHAR_HEIGHT, TEXT_CHAR_HEIGHT, fbWidth);
         }
+        gfx.textShadowValid = true;
         
         // Emit frame
-        EmitFrame(s_framebuffer.data(), fbWidth, fbHeight, fbWidth * 4);
+        if (dirtyCount > 0 || fullFrame)
+        {
+            gfx.emittedWidth = fbWidth;
+            gfx.emittedHeight = fbHeight;
+            EmitFrame(gfx.framebuffer.data(), fbWidth, fbHeight, fbWidth * 4, dirty, fullFrame ? 0 : dirtyCount);
+        }
     }
     else {
-        // Graphics mode: render from backing store like native
-        if (s_framebuffer.size() != GRAPHICS_MODE_WIDTH * GRAPHICS_MODE_HEIGHT * 4) {
-            s_framebuffer.resize(GRAPHICS_MODE_WIDTH * GRAPHICS_MODE_HEIGHT * 4);
+        // Graphics mode: render from backing store like native, each EGA
+        // pixel 4 wide so frames have the text mode size
+        const int fbWidth = GRAPHICS_MODE_WIDTH * GRAPHICS_PIXEL_WIDTH;
+        if (gfx.framebuffer.size() != fbWidth * GRAPHICS_MODE_HEIGHT * 4) {
+            gfx.framebuffer.resize(fbWidth * GRAPHICS_MODE_HEIGHT * 4);
         }
 
-        for (int y = 0; y < GRAPHICS_MODE_HEIGHT; ++y) {
-            for (int x = 0; x < GRAPHICS_MODE_WIDTH; ++x) {
-                // Display page base is 0xA000 -> offset index 0 in our arrays
-                const uint32_t pixel = graphicsPixels[y * GRAPHICS_MODE_WIDTH + x]; // already y-flipped at write time
-                const uint8_t r = (pixel >> 16) & 0xFF;
-                const uint8_t g = (pixel >> 8) & 0xFF;
-                const uint8_t b = (pixel >> 0) & 0xFF;
-
-                const int idx = (y * GRAPHICS_MODE_WIDTH + x) * 4;
-                s_framebuffer[idx + 0] = b;
-                s_framebuffer[idx + 1] = g;
-                s_framebuffer[idx + 2] = r;
-                s_framebuffer[idx + 3] = 0xFF;
-            }
+        // The text framebuffer is gone once graphics are drawn into it
+        gfx.textShadowValid = false;
+
+        // EGA index -> BGRA through the current palette
+        uint32_t palette[16];
+        for (int i = 0; i < 16; ++i)
+        {
+            palette[i] = ColorBGRA(i);
         }
 
-        EmitFrame(s_framebuffer.data(), GRAPHICS_MODE_WIDTH, GRAPHICS_MODE_HEIGHT, GRAPHICS_MODE_WIDTH * 4);
+        uint32_t* out = reinterpret_cast<uint32_t*>(gfx.framebuffer.data());
+        const uint8_t* pixels = frame.pixels.data(); // already y-flipped at write time
+        for (int y = 0; y < GRAPHICS_MODE_HEIGHT; ++y)
+        {
+            if (!frame.rows[y]) continue;
+            addRows(y, 1, fbWidth);
+            ConvertIndexRow(pixels + y * GRAPHICS_MODE_WIDTH, GRAPHICS_MODE_WIDTH, GRAPHICS_PIXEL_WIDTH, palette, out + y * fbWidth);
+        }
+
+        if (dirtyCount > 0 || fullFrame)
+        {
+            gfx.emittedWidth = fbWidth;
+            gfx.emittedHeight = GRAPHICS_MODE_HEIGHT;
+            EmitFrame(gfx.framebuffer.data(), fbWidth, GRAPHICS_MODE_HEIGHT, fbWidth * 4, dirty, fullFrame ? 0 : dirtyCount);
+        }
     }
 
-    // Emit rotoscope debug buffer once per frame
-    EmitRotoscopeDebug();
+    // Emit rotoscope debug buffer when the display page changed
+    EmitRotoscopeDebug(gfx, frame);
 }
 
 void GraphicsMode(int mode)
 {
-    s_graphicsMode.store(mode);
+    CurrentGraphics().graphicsMode.store(mode);
 }
 
 void GraphicsClear(int color, uint32_t offset, int byteCount)
 {
-    std::lock_guard<std::mutex> lg(rotoscopePixelMutex);
+    GraphicsState& gfx = CurrentGraphics();
     uint32_t dest = (uint32_t)offset;
 
     dest <<= 4; // Convert to linear addres
@@ -231,21 +787,23 @@ void GraphicsClear(int color, uint32_t offset, int byteCount)
 
     uint32_t destOffset = 0;
 
-    auto c = colortable[color&0xF];
-
     byteCount = 0x2000;
 
-    for(uint32_t i = 0; i < (uint32_t)byteCount * 4; ++i)
-    {
-        graphicsPixels[dest + destOffset + i] = c;
-        rotoscopePixels[dest + destOffset + i] = ClearPixel;
-    }
+    memset(&gfx.graphicsIndex[dest + destOffset], color & 0xF, (uint32_t)byteCount * 4);
+    ClearRotoscope(gfx, dest + destOffset, (uint32_t)byteCount * 4);
+    MarkDirty(gfx, dest + destOffset, (uint32_t)byteCount * 4);
 }
 
-void GraphicsPixelDirect(int x, int y, uint32_t color, uint32_t offset, Rotoscope pc)
+// EGA index of a 0x00RRGGBB color, 0 if it is not in the palette
+static inline uint8_t EgaIndex(uint32_t pixel)
 {
-    std::lock_guard<std::mutex> lg(rotoscopePixelMutex);
+    for (int i = 0; i < 16; ++i) if (colortable[i] == pixel) return (uint8_t)i;
+    return 0;
+}
 
+// Backing store index of the first pixel of buffer segment offset
+static inline uint32_t PageBase(uint32_t offset)
+{
     if (offset == 0)
     {
         offset = 0xA000;
@@ -255,69 +813,288 @@ void GraphicsPixelDirect(int x, int y, uint32_t color, uint32_t offset, Rotoscop
     base <<= 4;          // segment->linear
     base -= 0xA0000;     // subtract EGA base
     base *= 4;           // 4-byte pixels
+    return base;
+}
 
+// Backing store index of (x, y) in segment offset, false if off screen
+static inline bool PixelIndex(int x, int y, uint32_t offset, uint32_t& idx)
+{
     int yy = 199 - y;
     if (x < 0 || x >= GRAPHICS_MODE_WIDTH || yy < 0 || yy >= GRAPHICS_MODE_HEIGHT)
+    {
+        return false;
+    }
+
+    idx = yy * GRAPHICS_MODE_WIDTH + x + PageBase(offset);
+    return true;
+}
+
+void GraphicsPixelDirect(int x, int y, uint32_t color, uint32_t offset, const Rotoscope& pc)
+{
+    uint32_t idx;
+    if (PixelIndex(x, y, offset, idx))
+    {
+        StorePixel(CurrentGraphics(), idx, EgaIndex(color), pc);
+    }
+}
+
+void GraphicsPixel(int x, int y, int color, uint32_t offset, const Rotoscope& pc)
+{
+    uint32_t idx;
+    if (PixelIndex(x, y, offset, idx))
+    {
+        StorePixel(CurrentGraphics(), idx, color & 0xF, pc);
+    }
+}
+
+void GraphicsFillSpan(int y, int x0, int x1, int color, uint32_t offset, const Rotoscope& pc)
+{
+    const int yy = 199 - y;
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, GRAPHICS_MODE_WIDTH - 1);
+    if (yy < 0 || yy >= GRAPHICS_MODE_HEIGHT || x0 > x1)
     {
         return;
     }
 
-    pc.argb = color;
-    const uint32_t idx = yy * GRAPHICS_MODE_WIDTH + x + base;
-    rotoscopePixels[idx] = pc;
-    graphicsPixels[idx] = color;
+    GraphicsState& gfx = CurrentGraphics();
+    const uint32_t idx = yy * GRAPHICS_MODE_WIDTH + x0 + PageBase(offset);
+    const int count = x1 - x0 + 1;
+
+    MarkDirty(gfx, idx, count);
+    memset(&gfx.graphicsIndex[idx], color & 0xF, count);
+    memset(&gfx.rotoContent[idx], (uint8_t)pc.content, count);
+    std::fill_n(&gfx.rotoColors[idx], count, PackColors(pc));
+    std::fill_n(&gfx.rotoPosition[idx], count, PackPosition(pc));
+    std::fill_n(&gfx.rotoMeta[idx], count, InternMeta(gfx, pc));
 }
 
-void GraphicsPixel(int x, int y, int color, uint32_t offset, Rotoscope pc)
+// Byte masks for 8 image bits, most significant bit first in memory order
+static const std::array<uint64_t, 256> s_bitMasks = []()
+{
+    std::array<uint64_t, 256> masks{};
+    for (int bits = 0; bits < 256; ++bits)
+    {
+        uint8_t bytes[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            bytes[i] = (bits & (0x80 >> i)) ? 0xFF : 0x00;
+        }
+        memcpy(&masks[bits], bytes, sizeof(bytes));
+    }
+    return masks;
+}();
+
+// count <= 8 bits of a 1bpp MSB-first image starting at bit, in the top of a byte
+static inline uint8_t ImageBits(const uint16_t* image, int bit, int count)
 {
-    pc.EGAcolor = color & 0xF;
-    GraphicsPixelDirect(x, y, colortable[color & 0xF], offset, pc);
+    const int word = bit >> 4;
+    const int shift = bit & 15;
+    uint32_t window = (uint32_t)image[word] << 16;
+    if (shift + count > 16)
+    {
+        window |= image[word + 1];
+    }
+    return (uint8_t)((window << shift) >> 24);
 }
 
-uint32_t GraphicsPeekDirect(int x, int y, uint32_t offset, Rotoscope* pc)
+void GraphicsBlitRow(int y, int x0, int w, const uint16_t* image, int bit, int color, int xormode, uint32_t offset, const Rotoscope& pc)
 {
-    if(offset == 0)
+    const int yy = 199 - y;
+    const int first = std::max(0, -x0);
+    const int last = std::min(w, GRAPHICS_MODE_WIDTH - x0);
+    if (yy < 0 || yy >= GRAPHICS_MODE_HEIGHT || first >= last)
     {
-        offset = 0xa000;
+        return;
     }
 
-    offset <<= 4; // Convert to linear addres
-    offset -= 0xa0000; // Subtract from EGA page
-    offset *= 4; // Convert to our SDL memory linear address
+    GraphicsState& gfx = CurrentGraphics();
+    const uint32_t start = yy * GRAPHICS_MODE_WIDTH + x0 + first + PageBase(offset);
+    const int count = last - first;
+    bit += first;
+    color &= 0xF;
+
+    MarkDirty(gfx, start, count);
+    uint8_t* index = &gfx.graphicsIndex[start];
+    uint8_t* content = &gfx.rotoContent[start];
+    uint16_t* colors = &gfx.rotoColors[start];
+    uint8_t src[GRAPHICS_MODE_WIDTH];
+    uint8_t set[GRAPHICS_MODE_WIDTH];
+    memcpy(src, index, count);
+
+    // Expand the image bits to byte masks and blend 8 pixels at a time
+    const uint64_t colorBytes = 0x0101010101010101ull * (uint64_t)color;
+    for (int i = 0; i < count; i += 8)
+    {
+        const int n = std::min(8, count - i);
+        const uint64_t mask = s_bitMasks[ImageBits(image, bit + i, n)];
+        uint64_t pixels = 0;
+        memcpy(&pixels, src + i, n);
+        pixels = xormode ? pixels ^ (colorBytes & mask) : (pixels & ~mask) | (colorBytes & mask);
+        memcpy(index + i, &pixels, n);
+        memcpy(set + i, &mask, n);
+    }
 
-    y = 199 - y;
+    // XOR over text keeps the glyph it hits and flips its colors
+    bool keepText = false;
+    if (xormode)
+    {
+        for (int i = 0; i < count && !keepText; ++i)
+        {
+            keepText = set[i] && content[i] == TextPixel;
+        }
+    }
 
-    if(x < 0 || x >= GRAPHICS_MODE_WIDTH || y < 0 || y >= GRAPHICS_MODE_HEIGHT)
+    const uint16_t meta = InternMeta(gfx, pc);
+    const int bltX = pc.blt_x + first;
+    if (!keepText)
     {
-        return colortable[0];
+        memset(content, (uint8_t)pc.content, count);
+        if (pc.content == TextPixel)
+        {
+            for (int i = 0; i < count; ++i) colors[i] = PackColors(pc.fgColor, src[i]);
+        }
+        else
+        {
+            std::fill_n(colors, count, PackColors(pc));
+        }
+        for (int i = 0; i < count; ++i) gfx.rotoPosition[start + i] = PackPosition(bltX + i, pc.blt_y);
+        std::fill_n(&gfx.rotoMeta[start], count, meta);
+        return;
     }
 
-    if(pc)
+    for (int i = 0; i < count; ++i)
     {
-        *pc = rotoscopePixels[y * GRAPHICS_MODE_WIDTH + x + offset];
+        if (set[i] && content[i] == TextPixel)
+        {
+            colors[i] ^= PackColors((uint8_t)color, (uint8_t)color);
+            continue;
+        }
+        content[i] = (uint8_t)pc.content;
+        colors[i] = PackColors(pc.fgColor, pc.content == TextPixel ? src[i] : pc.bgColor);
+        gfx.rotoPosition[start + i] = PackPosition(bltX + i, pc.blt_y);
+        gfx.rotoMeta[start + i] = meta;
     }
+}
+
+void GraphicsCopyRect(int srcX, int srcY, int w, int h, int dstX, int dstY, uint32_t srcOffset, uint32_t dstOffset, const Rotoscope* pc)
+{
+    // Destination columns on screen, and the part of them whose source is on screen too
+    const int first = std::max(0, -dstX);
+    const int last = std::min(w, GRAPHICS_MODE_WIDTH - dstX);
+    const int copyFirst = std::max(first, -srcX);
+    const int copyLast = std::min(last, GRAPHICS_MODE_WIDTH - srcX);
+    if (first >= last || h <= 0)
+    {
+        return;
+    }
+
+    GraphicsState& gfx = CurrentGraphics();
+    const uint32_t srcBase = PageBase(srcOffset);
+    const uint32_t dstBase = PageBase(dstOffset);
+
+    // Pixels whose source is off screen read back as color 0 with a blank rotoscope
+    Rotoscope blank = pc ? *pc : Rotoscope();
+
+    // Walk rows away from the overlap so a move within one buffer is safe
+    const bool downward = (int)dstBase + (199 - dstY) * GRAPHICS_MODE_WIDTH <= (int)srcBase + (199 - srcY) * GRAPHICS_MODE_WIDTH;
+    for (int n = 0; n < h; ++n)
+    {
+        const int row = downward ? n : h - 1 - n;
+        const int sy = 199 - (srcY - row);
+        const int dy = 199 - (dstY - row);
+        if (dy < 0 || dy >= GRAPHICS_MODE_HEIGHT)
+        {
+            continue;
+        }
+
+        const uint32_t d = dstBase + dy * GRAPHICS_MODE_WIDTH + dstX;
+        MarkDirty(gfx, d + first, last - first);
+
+        const bool copyRow = sy >= 0 && sy < GRAPHICS_MODE_HEIGHT && copyFirst < copyLast;
+        if (copyRow)
+        {
+            const uint32_t s = srcBase + sy * GRAPHICS_MODE_WIDTH + srcX;
+            const int count = copyLast - copyFirst;
+            memmove(&gfx.graphicsIndex[d + copyFirst], &gfx.graphicsIndex[s + copyFirst], count);
+            memmove(&gfx.rotoColors[d + copyFirst], &gfx.rotoColors[s + copyFirst], count * sizeof(uint16_t));
+            if (pc)
+            {
+                // The source pixel keeps its colors and primitive data; pc sets what it is now, its blit
+                // position and size. Run against the copy direction in case both spans share a row.
+                for (int j = 0; j < count; ++j)
+                {
+                    const int i = (int)d > (int)s ? copyLast - 1 - j : copyFirst + j;
+                    RotoscopeMeta meta = gfx.rotoMetaTable[gfx.rotoMeta[s + i]];
+                    meta.bltW = pc->blt_w;
+                    meta.bltH = pc->blt_h;
+                    gfx.rotoMeta[d + i] = InternMeta(gfx, meta);
+                    gfx.rotoPosition[d + i] = PackPosition(pc->blt_x + i, pc->blt_y + row);
+                }
+                memset(&gfx.rotoContent[d + copyFirst], (uint8_t)pc->content, count);
+            }
+            else
+            {
+                memmove(&gfx.rotoContent[d + copyFirst], &gfx.rotoContent[s + copyFirst], count);
+                memmove(&gfx.rotoPosition[d + copyFirst], &gfx.rotoPosition[s + copyFirst], count * sizeof(uint32_t));
+                memmove(&gfx.rotoMeta[d + copyFirst], &gfx.rotoMeta[s + copyFirst], count * sizeof(uint16_t));
+            }
+        }
+
+        if (copyRow && copyFirst == first && copyLast == last)
+        {
+            continue;
+        }
+
+        // Blank the rest after the copy, it may overlap the source of this row
+        const uint16_t blankMeta = InternMeta(gfx, blank);
+        for (int i = first; i < last; ++i)
+        {
+            if (copyRow && i >= copyFirst && i < copyLast)
+            {
+                continue;
+            }
+            if (pc)
+            {
+                blank.blt_x = pc->blt_x + i;
+                blank.blt_y = pc->blt_y + row;
+            }
+            gfx.graphicsIndex[d + i] = 0;
+            gfx.rotoContent[d + i] = (uint8_t)blank.content;
+            gfx.rotoColors[d + i] = PackColors(blank);
+            gfx.rotoPosition[d + i] = PackPosition(blank);
+            gfx.rotoMeta[d + i] = blankMeta;
+        }
+    }
+}
 
-    return graphicsPixels[y * GRAPHICS_MODE_WIDTH + x + offset];
+uint32_t GraphicsPeekDirect(int x, int y, uint32_t offset, Rotoscope* pc)
+{
+    return colortable[GraphicsPeek(x, y, offset, pc)];
 }
 
 uint8_t GraphicsPeek(int x, int y, uint32_t offset, Rotoscope* pc)
 {
-    const uint32_t pixel = GraphicsPeekDirect(x, y, offset, pc);
-    for (int i = 0; i < 16; ++i) if (colortable[i] == pixel) return (uint8_t)i;
-    return 0;
+    uint32_t idx;
+    if (!PixelIndex(x, y, offset, idx))
+    {
+        return 0;
+    }
+
+    const GraphicsState& gfx = CurrentGraphics();
+    if (pc)
+    {
+        LoadRotoscope(gfx, idx, *pc);
+    }
+    return gfx.graphicsIndex[idx];
 }
 
 void GraphicsLine(int x1, int y1, int x2, int y2, int color, int xormode, uint32_t offset)
 {
-    float x = (float)x1;
-    float y = (float)y1;
-    float dx = (float)(x2 - x1);
-    float dy = (float)(y2 - y1);
-    int n = (int)fabsf(dx);
-    if ((int)fabsf(dy) > n) n = (int)fabsf(dy);
+    const int dx = x2 - x1;
+    const int dy = y2 - y1;
+    const int n = std::max(abs(dx), abs(dy));
     if (n == 0) return;
-    dx /= n;
-    dy /= n;
 
     Rotoscope rs{};
     rs.content = LinePixel;
@@ -328,85 +1105,63 @@ void GraphicsLine(int x1, int y1, int x2, int y2, int color, int xormode, uint32
     rs.lineData.total = n;
     rs.fgColor = color;
 
-    for (int i = 0; i <= n; ++i)
+    // Step i plots major + i on the major axis and the truncated running sum
+    // of dminor/n on the minor one. The sum stays in float: exact fractions
+    // truncate differently on about a third of all lines. Steps that put the
+    // major axis off the page are not drawn, only summed.
+    const bool xMajor = abs(dx) >= abs(dy);
+    const int major = xMajor ? x1 : y1;
+    const int step = (xMajor ? dx : dy) > 0 ? 1 : -1;
+    const int limit = xMajor ? GRAPHICS_MODE_WIDTH : GRAPHICS_MODE_HEIGHT;
+    const int first = std::max(0, step > 0 ? -major : major - (limit - 1));
+    const int last = std::min(n, step > 0 ? limit - 1 - major : major);
+    if (first > last) return;
+
+    float minor = (float)(xMajor ? y1 : x1);
+    const float minorStep = (float)(xMajor ? dy : dx) / n;
+    for (int i = 0; i < first; ++i)
+    {
+        minor += minorStep;
+    }
+
+    GraphicsState& gfx = CurrentGraphics();
+    const uint32_t base = PageBase(offset);
+    const uint16_t meta = InternMeta(gfx, rs);
+    const uint8_t ega = color & 0xF;
+    const uint8_t fg = rs.fgColor;
+
+    for (int i = first; i <= last; ++i, minor += minorStep)
     {
-        rs.lineData.n = i;
-        rs.bgColor = GraphicsPeek((int)x, (int)y, offset);
-        GraphicsPixel((int)x, (int)y, color, offset, rs);
-        x += dx;
-        y += dy;
+        const int x = xMajor ? major + i * step : (int)minor;
+        const int yy = 199 - (xMajor ? (int)minor : major + i * step);
+        if (x < 0 || x >= GRAPHICS_MODE_WIDTH || yy < 0 || yy >= GRAPHICS_MODE_HEIGHT)
+        {
+            continue;
+        }
+
+        const uint32_t idx = base + yy * GRAPHICS_MODE_WIDTH + x;
+        MarkDirty(gfx, idx);
+        gfx.rotoColors[idx] = PackColors(fg, gfx.graphicsIndex[idx]);
+        gfx.graphicsIndex[idx] = ega;
+        gfx.rotoContent[idx] = LinePixel;
+        gfx.rotoPosition[idx] = (uint32_t)i;
+        gfx.rotoMeta[idx] = meta;
     }
 }
 
 void GraphicsBLT(int16_t x1, int16_t y1, int16_t h, int16_t w, const char* image, int color, int xormode, uint32_t offset, Rotoscope pc)
 {
-    auto img = (const short int*)image;
-    int n = 0;
-
-    uint16_t xoffset = 0;
-    uint16_t yoffset = 0;
+    auto img = (const uint16_t*)image;
 
     pc.blt_w = w;
     pc.blt_h = h;
+    pc.blt_x = 0;
 
-    for(int y=y1; y>y1-h; y--)
+    // Image bits run on from one row into the next
+    for(int row = 0; row < h; ++row)
     {
-        xoffset = 0;
-
-        for(int x=x1; x<x1+w; x++)
-        {
-            int x0 = x;
-            int y0 = y;
-
-            Rotoscope srcPc{};
-            bool hasPixel = false;
-            auto src = GraphicsPeek(x0, y0, offset, &srcPc);
-
-            pc.blt_x = xoffset;
-            pc.blt_y = yoffset;
-
-            if(pc.content == TextPixel)
-            {
-                pc.bgColor = src;
-            }
-
-            if ((*img) & (1<<(15-n)))
-            {
-                if(xormode) {
-                    auto xored = src ^ (color&0xF);
-
-                    if(srcPc.content == TextPixel)
-                    {
-                        srcPc.bgColor = srcPc.bgColor ^ (color & 0xf);
-                        srcPc.fgColor = srcPc.fgColor ^ (color & 0xf);
-                        GraphicsPixel(x0, y0, xored, offset, srcPc);
-                    }
-                    else
-                    {
-                        GraphicsPixel(x0, y0, xored, offset, pc);
-                    }
-                }
-                else
-                {
-                    GraphicsPixel(x0, y0, color, offset, pc);
-                }
-            }
-            else
-            {
-                GraphicsPixel(x0, y0, src, offset, pc);
-            }
-            
-            n++;
-            if (n == 16)
-            {
-                n = 0;
-                img++;
-            }
-
-            ++xoffset;
-        }
-
-        ++yoffset;
+        pc.blt_y = row;
+        GraphicsBlitRow(y1 - row, x1, w, img, row * w, color, xormode, offset, pc);
     }
 }
 
@@ -420,7 +1175,8 @@ void GraphicsText(char *s, int n)
 
 void GraphicsChar(unsigned char s)
 {
-    if (s_graphicsMode.load() != 0)
+    GraphicsState& gfx = CurrentGraphics();
+    if (gfx.graphicsMode.load() != 0)
     {
         // Graphics mode - ignore for now
         return;
@@ -429,13 +1185,14 @@ void GraphicsChar(unsigned char s)
     // Text mode - write character to text memory segment 0xB800
     // GraphicsUpdate() will render it from there
     uint32_t textMemBase = ComputeAddress(TEXT_SEGMENT, 0);
-    uint32_t offset = textMemBase + (s_cursorY * TEXT_WIDTH + s_cursorX) * 2;
+    uint32_t offset = textMemBase + (gfx.cursorY * TEXT_WIDTH + gfx.cursorX) * 2;
     
     m[offset] = s;          // Character
     m[offset + 1] = 0x07;   // Attribute (light gray on black)
+    MarkTextDirty(gfx, offset - textMemBase, 2);
     
-    s_cursorX++;
-    if (s_cursorX >= 80)
+    gfx.cursorX++;
+    if (gfx.cursorX >= 80)
     {
         GraphicsCarriageReturn();
     }
@@ -443,18 +1200,20 @@ void GraphicsChar(unsigned char s)
 
 void GraphicsCarriageReturn()
 {
-    s_cursorX = 0;
-    s_cursorY++;
-    if (s_cursorY >= TEXT_HEIGHT) {
-        s_cursorY = TEXT_HEIGHT - 1;
+    GraphicsState& gfx = CurrentGraphics();
+    gfx.cursorX = 0;
+    gfx.cursorY++;
+    if (gfx.cursorY >= TEXT_HEIGHT) {
+        gfx.cursorY = TEXT_HEIGHT - 1;
         // TODO: Scroll screen
     }
 }
 
 void GraphicsSetCursor(int x, int y)
 {
-    s_cursorX = x;
-    s_cursorY = y;
+    GraphicsState& gfx = CurrentGraphics();
+    gfx.cursorX = x;
+    gfx.cursorY = y;
 }
 
 int16_t GraphicsFONT(uint16_t num, uint32_t character, int x1, int y1, int color, int xormode, uint32_t offset)
@@ -512,7 +1271,7 @@ int16_t GraphicsFONT(uint16_t num, uint32_t character, int x1, int y1, int color
 
 void GraphicsCopyLine(uint16_t sourceSeg, uint16_t destSeg, uint16_t si, uint16_t di, uint16_t count)
 {
-    std::lock_guard<std::mutex> lg(rotoscopePixelMutex);
+    GraphicsState& gfx = CurrentGraphics();
 
     uint32_t src = (uint32_t)sourceSeg;
     uint32_t dest = (uint32_t)destSeg;
@@ -528,11 +1287,20 @@ void GraphicsCopyLine(uint16_t sourceSeg, uint16_t destSeg, uint16_t si, uint16_
     uint32_t srcOffset = (uint32_t)si * 4;
     uint32_t destOffset = (uint32_t)di * 4;
 
-    for(uint32_t i = 0; i < (uint32_t)count * 4; ++i)
+    // Plane by plane; a copy of a page onto itself or an overlapping one is a move
+    const uint32_t d = dest + destOffset;
+    const uint32_t s = src + srcOffset;
+    const uint32_t n = (uint32_t)count * 4;
+    if (d == s)
     {
-        graphicsPixels[dest + destOffset + i] = graphicsPixels[src + srcOffset + i];
-        rotoscopePixels[dest + destOffset + i] = rotoscopePixels[src + srcOffset + i];
+        return;
     }
+    memmove(&gfx.graphicsIndex[d], &gfx.graphicsIndex[s], n);
+    memmove(&gfx.rotoContent[d], &gfx.rotoContent[s], n);
+    memmove(&gfx.rotoColors[d], &gfx.rotoColors[s], n * sizeof(uint16_t));
+    memmove(&gfx.rotoPosition[d], &gfx.rotoPosition[s], n * sizeof(uint32_t));
+    memmove(&gfx.rotoMeta[d], &gfx.rotoMeta[s], n * sizeof(uint16_t));
+    MarkDirty(gfx, d, n);
 }
 
 void GraphicsSave(char *filename)
@@ -545,29 +1313,43 @@ void BeepTone(uint16_t pitFreq) {}
 void BeepOff() {}
 
 // Keyboard stubs
-static std::vector<uint16_t> s_keyQueue;
-static std::mutex s_keyMutex;
+void GraphicsRecordKeys(const char* path)
+{
+    GraphicsState& gfx = CurrentGraphics();
+    std::lock_guard<std::mutex> lock(gfx.keyMutex);
+    if (gfx.keyRecording) fclose(gfx.keyRecording);
+    gfx.keyRecording = path ? fopen(path, "w") : nullptr;
+}
 
 bool GraphicsHasKey()
 {
-    std::lock_guard<std::mutex> lock(s_keyMutex);
-    return !s_keyQueue.empty();
+    GraphicsState& gfx = CurrentGraphics();
+    std::lock_guard<std::mutex> lock(gfx.keyMutex);
+    return !gfx.keyQueue.empty();
 }
 
 uint16_t GraphicsGetKey()
 {
-    std::lock_guard<std::mutex> lock(s_keyMutex);
-    if (s_keyQueue.empty()) return 0;
+    GraphicsState& gfx = CurrentGraphics();
+    std::lock_guard<std::mutex> lock(gfx.keyMutex);
+    if (gfx.keyQueue.empty()) return 0;
     
-    uint16_t key = s_keyQueue.front();
-    s_keyQueue.erase(s_keyQueue.begin());
+    uint16_t key = gfx.keyQueue.front();
+    gfx.keyQueue.erase(gfx.keyQueue.begin());
     return key;
 }
 
 void GraphicsPushKey(uint16_t key)
 {
-    std::lock_guard<std::mutex> lock(s_keyMutex);
-    s_keyQueue.push_back(key);
+    GraphicsState& gfx = CurrentGraphics();
+    std::lock_guard<std::mutex> lock(gfx.keyMutex);
+    gfx.keyQueue.push_back(key);
+
+    if (gfx.keyRecording)
+    {
+        fprintf(gfx.keyRecording, "at %llu key 0x%04x\n", (unsigned long long)GetWordsExecuted(), key);
+        fflush(gfx.keyRecording);
+    }
 }
 
 void WaitForVBlank()
@@ -577,7 +1359,7 @@ void WaitForVBlank()
 
 bool IsGraphicsShutdown()
 {
-    return graphicsIsShutdown;
+    return CurrentGraphics().isShutdown;
 }
 
 void GraphicsMoveSpaceMan(uint16_t x, uint16_t y)
@@ -13,6 +13,20 @@ extern uint32_t colortable[16];
 void GraphicsInit();
 void GraphicsQuit();
 void GraphicsUpdate();
+// Emulator thread, when the game finished a frame: hands the display page to GraphicsUpdate() if it changed
+void GraphicsPublishFrame();
+// Presenter: blocks until a frame is published, a full frame is requested or the graphics shut down
+void GraphicsWaitFrame();
+// Any thread: the next GraphicsUpdate() emits the whole frame without dirty rects, even if nothing changed
+void GraphicsRequestFullFrame();
+// Presenter, inside the frame sink: steady_clock ns at which the emitted frame was published
+uint64_t GraphicsEmittedPublishTime();
+
+// Emulator thread: count bytes from linear address were stored, so GraphicsPublishFrame()
+// knows the text rows at B800:0000 that changed. Writes outside the text page are ignored.
+void GraphicsTextWritten(uint32_t address, uint32_t count);
+// Emulator thread: 8086 code ran and may have stored anywhere, the next publish compares the text page
+void GraphicsTextUnknown();
 
 void GraphicsMode(int mode); // 0 = text, 1 = ega graphics
 void GraphicsClear(int color, uint32_t offset, int byteCount);
@@ -22,10 +36,19 @@ void GraphicsSetCursor(int x, int y);
 void GraphicsChar(unsigned char s);
 void GraphicsLine(int x1, int y1, int x2, int y2, int color, int xormode, uint32_t offset);
 
-void GraphicsPixel(int x, int y, int color, uint32_t offset, Rotoscope rs = Rotoscope());
+void GraphicsPixel(int x, int y, int color, uint32_t offset, const Rotoscope& rs = Rotoscope());
 void GraphicsBLT(int16_t x1, int16_t y1, int16_t w, int16_t h, const char* image, int color, int xormode, uint32_t offset, Rotoscope rs = Rotoscope());
 void GraphicsSave(char *filename);
 
+// Spans, in the same flipped coordinates as GraphicsPixel and clipped to the page.
+// x0..x1 inclusive in color
+void GraphicsFillSpan(int y, int x0, int x1, int color, uint32_t offset, const Rotoscope& rs = Rotoscope());
+// w pixels of a 1bpp MSB-first image starting at bit; clear bits keep their color. rs.blt_x is the first pixel's
+void GraphicsBlitRow(int y, int x0, int w, const uint16_t* image, int bit, int color, int xormode, uint32_t offset, const Rotoscope& rs = Rotoscope());
+// w x h block going down from (srcX, srcY). Overlap safe; pixels whose source is off the page become color 0.
+// With rs, the copy keeps the source colors and primitive data and takes content, blt_x/blt_y and blt_w/blt_h from rs
+void GraphicsCopyRect(int srcX, int srcY, int w, int h, int dstX, int dstY, uint32_t srcOffset, uint32_t dstOffset, const Rotoscope* rs = nullptr);
+
 uint8_t GraphicsPeek(int x, int y, uint32_t offset, Rotoscope* rs = nullptr);
 int16_t GraphicsFONT(uint16_t num, uint32_t character, int x1, int y1, int color, int xormode, uint32_t offset);
 
@@ -38,6 +61,8 @@ void BeepOff();
 bool GraphicsHasKey();
 uint16_t GraphicsGetKey();
 void GraphicsPushKey(uint16_t key);
+// Appends every pushed key to path as an sfbench "at <words> key <code>" line, nullptr stops
+void GraphicsRecordKeys(const char* path);
 
 void WaitForVBlank();
 
@@ -45,6 +70,10 @@ bool IsGraphicsShutdown();
 
 // EGA color table
 extern uint32_t colortable[16];
-extern bool graphicsIsShutdown;
+
+// Per-context graphics planes and key queue, owned by EmulatorContext
+struct GraphicsState;
+GraphicsState* GraphicsCreateState();
+void GraphicsDestroyState(GraphicsState* state);
 
 #endif
@@ -0,0 +1,119 @@
+#include "pixelconvert.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SF_PIXELCONVERT_X64 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define SF_PIXELCONVERT_X64 0
+#endif
+
+#if SF_PIXELCONVERT_X64 && !defined(_MSC_VER)
+#define SF_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SF_TARGET_AVX2
+#endif
+
+void ConvertIndexRowScalar(const uint8_t* index, int count, int scale, const uint32_t* palette, uint32_t* out)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        const uint32_t pixel = palette[index[i] & 0xF];
+        for (int s = 0; s < scale; ++s)
+        {
+            *out++ = pixel;
+        }
+    }
+}
+
+#if SF_PIXELCONVERT_X64
+
+static bool DetectAVX2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    // AVX2 needs the OS to save the ymm registers too
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static const bool s_hasAVX2 = DetectAVX2();
+
+// 8 indices -> 8 BGRA pixels. permutevar8x32 looks up the low three bits in
+// each half of the palette and bit 3 picks the half.
+SF_TARGET_AVX2 static inline __m256i Lookup8(const uint8_t* index, __m256i paletteLo, __m256i paletteHi)
+{
+    const __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(index)));
+    const __m256i lo = _mm256_permutevar8x32_epi32(paletteLo, idx);
+    const __m256i hi = _mm256_permutevar8x32_epi32(paletteHi, idx);
+    const __m256i high = _mm256_slli_epi32(idx, 28);
+    return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi), _mm256_castsi256_ps(high)));
+}
+
+SF_TARGET_AVX2 static void ConvertAVX2(const uint8_t* index, int count, int scale, const uint32_t* palette, uint32_t* out)
+{
+    const __m256i paletteLo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(palette));
+    const __m256i paletteHi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(palette + 8));
+
+    int i = 0;
+    if (scale == 1)
+    {
+        for (; i + 8 <= count; i += 8, out += 8)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), Lookup8(index + i, paletteLo, paletteHi));
+        }
+    }
+    else if (scale == 4)
+    {
+        const __m256i spread0 = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+        const __m256i spread1 = _mm256_setr_epi32(2, 2, 2, 2, 3, 3, 3, 3);
+        const __m256i spread2 = _mm256_setr_epi32(4, 4, 4, 4, 5, 5, 5, 5);
+        const __m256i spread3 = _mm256_setr_epi32(6, 6, 6, 6, 7, 7, 7, 7);
+        for (; i + 8 <= count; i += 8, out += 32)
+        {
+            const __m256i pixels = Lookup8(index + i, paletteLo, paletteHi);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 0), _mm256_permutevar8x32_epi32(pixels, spread0));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 8), _mm256_permutevar8x32_epi32(pixels, spread1));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 16), _mm256_permutevar8x32_epi32(pixels, spread2));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 24), _mm256_permutevar8x32_epi32(pixels, spread3));
+        }
+    }
+    ConvertIndexRowScalar(index + i, count - i, scale, palette, out);
+}
+
+bool ConvertIndexRowAVX2(const uint8_t* index, int count, int scale, const uint32_t* palette, uint32_t* out)
+{
+    if (!s_hasAVX2) return false;
+    ConvertAVX2(index, count, scale, palette, out);
+    return true;
+}
+
+#else
+
+bool ConvertIndexRowAVX2(const uint8_t*, int, int, const uint32_t*, uint32_t*)
+{
+    return false;
+}
+
+#endif
+
+void ConvertIndexRow(const uint8_t* index, int count, int scale, const uint32_t* palette, uint32_t* out)
+{
+    if (!ConvertIndexRowAVX2(index, count, scale, palette, out))
+    {
+        ConvertIndexRowScalar(index, count, scale, palette, out);
+    }
+}
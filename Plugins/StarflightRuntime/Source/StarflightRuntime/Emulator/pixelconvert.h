@@ -0,0 +1,22 @@
+#ifndef PIXELCONVERT_H
+#define PIXELCONVERT_H
+
+#include <stdint.h>
+
+// ------------------------------------------------
+// EGA index -> BGRA conversion
+//
+// The presenter's only per-pixel stage: a row of 4-bit EGA indices goes
+// through a 16 entry palette of BGRA pixels (memory order) and every index
+// is written scale times, so a 160 wide graphics row comes out at the
+// 640 wide output size. ConvertIndexRow() uses AVX2 when the CPU has it.
+// ------------------------------------------------
+
+void ConvertIndexRow(const uint8_t* index, int count, int scale, const uint32_t* palette, uint32_t* out);
+
+// The implementations behind ConvertIndexRow(), for sfbench
+void ConvertIndexRowScalar(const uint8_t* index, int count, int scale, const uint32_t* palette, uint32_t* out);
+// Returns false, writing nothing, when the CPU has no AVX2
+bool ConvertIndexRowAVX2(const uint8_t* index, int count, int scale, const uint32_t* palette, uint32_t* out);
+
+#endif
@@ -0,0 +1,335 @@
+#pragma warning(disable: 4996) // CRT security warnings
+
+#include "primitives.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "cpu/cpu.h"
+#include "graphics.h"
+
+// Unreal Engine logging
+#include <stdarg.h>
+#include "Logging/LogMacros.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogStarflightPrimitives, Log, All);
+
+// Simple wrapper to redirect printf-style logging to UE
+static void SF_Log(const char* Format, ...)
+{
+	static thread_local char Buffer[4096];
+	va_list Args;
+	va_start(Args, Format);
+	vsnprintf(Buffer, sizeof(Buffer), Format, Args);
+	va_end(Args);
+	UE_LOG(LogStarflightPrimitives, Log, TEXT("%s"), ANSI_TO_TCHAR(Buffer));
+}
+
+// push/pop es and similar leave garbage below the parameter stack pointer
+static constexpr uint16_t StackScratchSize = 0x20;
+
+// ------------------------------------------------
+// Native code words
+//
+// Only words whose machine code is known are listed here. Everything else
+// stays on the 8086 path, see the comments next to the cases in call.cpp.
+// ------------------------------------------------
+
+static void LongExchange16(uint16_t es, uint16_t bx, uint16_t ax) // "{LXCHG}" 0x2f36
+{
+    uint16_t cx = Read16Long(es, bx);
+    uint16_t temp = Read16Long(es, ax);
+    Write16Long(es, ax, cx);
+    Write16Long(es, bx, temp);
+}
+
+static void LongExchange8(uint16_t es, uint16_t bx, uint16_t ax) // 0x49cc
+{
+    uint8_t cl = Read8Long(es, bx);
+    uint8_t temp = Read8Long(es, ax);
+    Write8Long(es, ax, cl);
+    Write8Long(es, bx, temp);
+}
+
+// 0x12a1: pop ax; neg ax; cwd; neg dx; push dx
+// Note that 0x8000 is treated as positive
+static void ZeroGreater()
+{
+    int16_t ax = (int16_t)(uint16_t)(-Pop());
+    Push(ax < 0 ? 1 : 0);
+}
+
+static void Prioritize() // "PRIORITIZE", see 0x7684 in call.cpp
+{
+    uint16_t ax = Pop();
+    if (ax != 0)
+    {
+        uint16_t bx = ax - 2;
+        LongExchange16(Read16(0x54EA), bx, ax); // LOISEG
+        LongExchange16(Read16(0x54F2), bx, ax); // LOCSEG
+        bx >>= 1;
+        ax >>= 1;
+        LongExchange8(Read16(0x54EE), bx, ax); // HIISEG
+        bx <<= 1;
+        ax = bx;
+    }
+    Push(ax);
+}
+
+static void UpdateCheck() // "?UPDATE", see 0x6D12 in call.cpp
+{
+    int16_t cx = (int16_t)Pop();
+    if (cx < 0)
+    {
+        uint16_t bx = Read16(0x54a1);
+        int16_t dx = (int16_t)(bx + 7);
+        if (cx > dx)
+        {
+            dx = (int16_t)(dx + 0x401);
+            if (dx > cx)
+            {
+                Write8(bx + 2, 0xff);
+            }
+            else
+            {
+                bx = Read16(0x54a5);
+                dx = (int16_t)(bx + 7);
+                if (cx > dx)
+                {
+                    dx = (int16_t)(dx + 0x401);
+                    if (dx > cx) Write8(bx + 2, 0xff);
+                }
+            }
+        }
+    }
+    else if ((int16_t)(cx - 0x63ef) >= 0 && (int16_t)(cx - 0x64fd) < 0)
+    {
+        Write8(0x63ee, 0xff);
+    }
+    Push((uint16_t)cx);
+}
+
+static void PushPoly() // "PUSH-POLY", see 0xee65 in call.cpp
+{
+    uint16_t es = (Read16(0x5DA3) & 1) ? Read16(0x52B3) : Read16(0x55D8); // ?EGA ? XBUF-SEG : HBUF-SEG
+    uint16_t bx = Pop();
+    uint16_t ax = Read8Long(es, bx);
+    bx++;
+    Push(Read16Long(es, bx));
+    bx += 2;
+    Push(Read16Long(es, bx));
+    Push(ax);
+}
+
+struct NativePrimitiveEntry
+{
+    uint16_t addr;
+    const char* name;
+    NativePrimitive function;
+};
+
+static const NativePrimitiveEntry s_nativePrimitives[] =
+{
+    // --- constants ---
+    { 0x0F22, "0", []() { Push(0); } },
+    { 0x0F30, "1", []() { Push(1); } },
+    { 0x0F3F, "2", []() { Push(2); } },
+    { 0x175F, "LIT", []() { Push(Read16(regsi)); regsi += 2; } },
+
+    // --- arithmetic and logic ---
+    { 0x1340, "OR", []() { uint16_t b = Pop(); Push(Pop() | b); } },
+    { 0x12F7, "AND", []() { uint16_t b = Pop(); Push(Pop() & b); } },
+    { 0x1366, "XOR", []() { uint16_t b = Pop(); Push(Pop() ^ b); } },
+    { 0x0F74, "+", []() { uint16_t b = Pop(); Push(Pop() + b); } },
+    { 0x0F94, "-", []() { uint16_t b = Pop(); Push(Pop() - b); } },
+    { 0x0FB5, "*", []() { uint16_t b = Pop(); Push(Pop() * b); } },
+    { 0x11C8, "NEGATE", []() { Push(-Pop()); } },
+    { 0x1309, "NOT", []() { Push(Pop() == 0 ? 1 : 0); } },
+    { 0x128B, "0=", []() { Push(Pop() == 0 ? 1 : 0); } },
+    { 0x1007, "2*", []() { Push(Pop() << 1); } },
+    { 0x4984, "3+", []() { Push(Pop() + 3); } },
+    { 0x0FE9, "1+", []() { Push(Pop() + 1); } },
+    { 0x0FF8, "1-", []() { Push(Pop() - 1); } },
+    { 0x1017, "2+", []() { Push(Pop() + 2); } },
+    { 0x1027, "2-", []() { Push(Pop() - 2); } },
+    { 0x1037, "2/", []() { Push((uint16_t)((int16_t)Pop() >> 1)); } },
+    { 0x4949, "16*", []() { Push(Pop() << 4); } },
+    { 0x11D8, "U*", []() { uint32_t b = Pop(); uint32_t r = Pop() * b; Push(r & 0xffff); Push(r >> 16); } },
+
+    // --- comparisons ---
+    { 0x1261, "=", []() { uint16_t b = Pop(); Push(Pop() == b ? 1 : 0); } },
+    { 0x127a, "0<", []() { Push((int16_t)Pop() < 0 ? 1 : 0); } },
+    { 0x12a1, "0>", ZeroGreater },
+    { 0x1248, "<", []() { int16_t b = (int16_t)Pop(); Push((int16_t)Pop() < b ? 1 : 0); } },
+    { 0x122F, ">", []() { int16_t b = (int16_t)Pop(); Push((int16_t)Pop() > b ? 1 : 0); } },
+    { 0x12E1, "U<", []() { uint16_t b = Pop(); Push(Pop() < b ? 1 : 0); } },
+
+    // --- double numbers, high cell on top ---
+    { 0x1508, "S->D", []() { uint16_t ax = Pop(); Push(ax); Push((int16_t)ax < 0 ? 0xffff : 0); } },
+    { 0x1067, "D+", []() {
+        uint32_t b = (uint32_t)Pop() << 16; b |= Pop();
+        uint32_t a = (uint32_t)Pop() << 16; a |= Pop();
+        uint32_t r = a + b;
+        Push(r & 0xffff); Push(r >> 16); } },
+    { 0x10B9, "DNEGATE", []() {
+        uint32_t a = (uint32_t)Pop() << 16; a |= Pop();
+        uint32_t r = 0u - a;
+        Push(r & 0xffff); Push(r >> 16); } },
+    { 0x495E, "D16*", []() {
+        uint32_t a = (uint32_t)Pop() << 16; a |= Pop();
+        uint32_t r = a << 4;
+        Push(r & 0xffff); Push(r >> 16); } },
+    { 0x4b08, "D2*", []() {
+        uint32_t a = (uint32_t)Pop() << 16; a |= Pop();
+        uint32_t r = a << 1;
+        Push(r & 0xffff); Push(r >> 16); } },
+
+    // --- memory ---
+    { 0x0BB0, "@", []() { Push(Read16(Pop())); } },
+    { 0x0C94, "C@", []() { Push(Read8(Pop())); } },
+    { 0x4bc5, "+-@", []() { Push((uint16_t)(int16_t)(int8_t)Read8(Pop())); } },
+    { 0x0BE1, "!", []() { uint16_t addr = Pop(); Write16(addr, Pop()); } },
+    { 0x0C60, "C!", []() { uint16_t addr = Pop(); Write8(addr, Pop() & 0xff); } },
+    { 0x0F85, "+!", []() { uint16_t addr = Pop(); Write16(addr, Read16(addr) + Pop()); } },
+    { 0x1355, "TOGGLE", []() { uint8_t bits = Pop() & 0xff; uint16_t addr = Pop(); Write8(addr, Read8(addr) ^ bits); } },
+    { 0x0C3A, "2@", []() { uint16_t addr = Pop(); Push(Read16(addr + 2)); Push(Read16(addr)); } },
+    { 0x0C24, "2!", []() { uint16_t addr = Pop(); Write16(addr, Pop()); Write16(addr + 2, Pop()); } },
+    { 0x2EA4, "L@", []() { uint16_t o = Pop(); uint16_t s = Pop(); Push(Read16Long(s, o)); } },
+    { 0x2eCD, "LC@", []() { uint16_t o = Pop(); uint16_t s = Pop(); Push(Read8Long(s, o)); } },
+    { 0x49f0, "L+-@", []() { uint16_t o = Pop(); uint16_t s = Pop(); Push((uint16_t)(int16_t)(int8_t)Read8Long(s, o)); } },
+    { 0x2EB8, "L!", []() { uint16_t o = Pop(); uint16_t s = Pop(); Write16Long(s, o, Pop()); } },
+    { 0x2EE5, "LC!", []() { uint16_t o = Pop(); uint16_t s = Pop(); Write8Long(s, o, Pop() & 0xff); } },
+    { 0x0D10, "CMOVE", []() {
+        uint16_t count = Pop(); uint16_t to = Pop(); uint16_t from = Pop();
+        for (uint16_t i = 0; i < count; i++) Write8(to + i, Read8(from + i)); } },
+    { 0x0D35, "FILL", []() {
+        uint8_t b = Pop() & 0xff; uint16_t count = Pop(); uint16_t addr = Pop();
+        for (uint16_t i = 0; i < count; i++) Write8(addr + i, b); } },
+
+    // --- stack ---
+    { 0x0EF4, "SWAP", []() { uint16_t b = Pop(); uint16_t a = Pop(); Push(b); Push(a); } },
+    { 0x0EB5, "ROT", []() { uint16_t c = Pop(); uint16_t b = Pop(); uint16_t a = Pop(); Push(b); Push(c); Push(a); } },
+    { 0x0E08, "2SWAP", []() {
+        uint16_t d = Pop(); uint16_t c = Pop(); uint16_t b = Pop(); uint16_t a = Pop();
+        Push(c); Push(d); Push(a); Push(b); } },
+
+    // --- overlay words with known disassembly ---
+    { 0x7684, "PRIORITIZE", Prioritize },
+    { 0x6D12, "?UPDATE", UpdateCheck },
+    { 0x9aba, "!IB", []() { uint16_t es = Pop(); uint16_t cx = Pop(); Write8Long(es, Read16(0x5A02), cx & 0xff); } },
+    { 0x9a9e, "!IW", []() { uint16_t es = Pop(); uint16_t cx = Pop(); Write16Long(es, Read16(0x5A02) << 1, cx); } },
+    { 0xed62, "!TMP", []() { uint16_t bx = -(Pop() << 1) + Read16(0xED30); Write16(bx, Pop()); } },
+    { 0xee65, "PUSH-POLY", PushPoly },
+    { 0xeee5, "", []() { Push(0); Push(0x0404); Push(Read16(0xED81)); } },
+    { 0xeecc, "", []() { Push(Read16(regsp) == Read16(0xED81) ? 1 : 0); } },
+    { 0xeec2, "", []() { regsp += 6; } },
+    { 0xdf02, "", []() { Write16(0xDC20, regsp); } },
+};
+
+// Maps a code field address to its index in s_nativePrimitives plus one
+static uint8_t s_nativePrimitiveIndex[0x10000];
+
+static bool BuildNativePrimitiveIndex()
+{
+    static_assert(sizeof(s_nativePrimitives) / sizeof(s_nativePrimitives[0]) < 0xff, "index table is 8 bit");
+    for (size_t i = 0; i < sizeof(s_nativePrimitives) / sizeof(s_nativePrimitives[0]); i++)
+    {
+        s_nativePrimitiveIndex[s_nativePrimitives[i].addr] = (uint8_t)(i + 1);
+    }
+    return true;
+}
+
+static bool s_nativePrimitiveIndexBuilt = BuildNativePrimitiveIndex();
+static bool s_verifyPrimitives = false;
+
+static const NativePrimitiveEntry* FindNativePrimitiveEntry(uint16_t addr)
+{
+    uint8_t index = s_nativePrimitiveIndex[addr];
+    return index ? &s_nativePrimitives[index - 1] : nullptr;
+}
+
+NativePrimitive FindNativePrimitive(uint16_t addr)
+{
+    const NativePrimitiveEntry* entry = FindNativePrimitiveEntry(addr);
+    return entry ? entry->function : nullptr;
+}
+
+void EnablePrimitiveVerification(bool enable)
+{
+    s_verifyPrimitives = enable;
+}
+
+bool IsPrimitiveVerificationEnabled()
+{
+    return s_verifyPrimitives;
+}
+
+// ------------------------------------------------
+// Differential mode
+// ------------------------------------------------
+
+static bool IsIgnoredAddress(uint32_t address, uint16_t sp)
+{
+    uint32_t stackBase = ComputeAddress(StarflightBaseSegment, (uint16_t)(sp - StackScratchSize));
+    return address >= stackBase && address < stackBase + StackScratchSize;
+}
+
+static void VerifyPrimitive(const NativePrimitiveEntry& entry)
+{
+    static thread_local std::vector<uint8_t> before;
+    static thread_local std::vector<uint8_t> afterNative;
+
+    before.assign(currentMemory, currentMemory + SystemMemorySize);
+    CPUContext start = { regsp, regbp, regsi, regbx };
+
+    entry.function();
+    CPUContext nativeContext = { regsp, regbp, regsi, regbx };
+    afterNative.assign(currentMemory, currentMemory + SystemMemorySize);
+
+    memcpy(currentMemory, before.data(), SystemMemorySize);
+    regsp = start.regsp;
+    regbp = start.regbp;
+    regsi = start.regsi;
+    regbx = start.regbx;
+
+    Run8086(StarflightBaseSegment, entry.addr, StarflightBaseSegment, StarflightBaseSegment, &regsp);
+    GraphicsTextUnknown();
+
+    if (nativeContext.regsp != regsp || nativeContext.regbp != regbp || nativeContext.regsi != regsi)
+    {
+        SF_Log("Primitive 0x%04x '%s' register mismatch: native sp=%04x bp=%04x si=%04x, 8086 sp=%04x bp=%04x si=%04x\n",
+            entry.addr, entry.name, nativeContext.regsp, nativeContext.regbp, nativeContext.regsi, regsp, regbp, regsi);
+    }
+
+    uint16_t lowestSp = nativeContext.regsp < regsp ? nativeContext.regsp : regsp;
+    int reported = 0;
+    for (uint32_t i = 0; i < SystemMemorySize && reported < 8; i++)
+    {
+        if (afterNative[i] == currentMemory[i] || IsIgnoredAddress(i, lowestSp))
+            continue;
+
+        SF_Log("Primitive 0x%04x '%s' memory mismatch at 0x%05x: native 0x%02x, 8086 0x%02x\n",
+            entry.addr, entry.name, i, afterNative[i], currentMemory[i]);
+        reported++;
+    }
+}
+
+void ExecutePrimitive(uint16_t addr)
+{
+    const NativePrimitiveEntry* entry = FindNativePrimitiveEntry(addr);
+    if (entry == nullptr)
+    {
+        Run8086(StarflightBaseSegment, addr, StarflightBaseSegment, StarflightBaseSegment, &regsp);
+        GraphicsTextUnknown();
+        return;
+    }
+
+    if (s_verifyPrimitives)
+    {
+        VerifyPrimitive(*entry);
+        return;
+    }
+
+    entry->function();
+}
@@ -0,0 +1,22 @@
+#ifndef PRIMITIVES_H
+#define PRIMITIVES_H
+
+#include <stdint.h>
+
+// Native replacements for Forth code words that are otherwise executed
+// instruction by instruction through the 8086 core.
+
+typedef void (*NativePrimitive)();
+
+// Returns the native implementation of the code word at addr or nullptr
+NativePrimitive FindNativePrimitive(uint16_t addr);
+
+// Runs the code word at addr natively if possible, otherwise through Run8086
+void ExecutePrimitive(uint16_t addr);
+
+// Differential mode: every native primitive is also run through the 8086 core
+// from the same starting state and any divergence is logged.
+void EnablePrimitiveVerification(bool enable);
+bool IsPrimitiveVerificationEnabled();
+
+#endif
@@ -4,6 +4,7 @@
 #include "StarflightBridge.h"
 #include "cpu/cpu.h"
 #include "call.h"
+#include "calltrace.h"
 #include "graphics.h"
 #include "Misc/Paths.h"
 #include "Logging/LogMacros.h"
@@ -14,8 +15,8 @@
 #include <mutex>
 #include <thread>
 #include <vector>
-#include <chrono>
 #include <string>
+#include <stdlib.h>
 
 // Global variable to hold project directory for emulator file loading
 std::string g_ProjectDirectory;
@@ -46,6 +47,19 @@ void SetFrameSink(FrameSinkFn cb)
 	gFrameSink = std::move(cb);
 }
 
+void RequestFullFrame()
+{
+	if (gRunning.load(std::memory_order_acquire))
+	{
+		GraphicsRequestFullFrame();
+	}
+}
+
+uint64_t GetFramePublishTime()
+{
+	return GraphicsEmittedPublishTime();
+}
+
 void SetAudioSink(AudioSinkFn cb)
 {
 	std::lock_guard<std::mutex> lock(gSinksMutex);
@@ -77,6 +91,12 @@ void StartStarflight()
 	// Initialize graphics
 	GraphicsInit();
 
+	// Record input as an sfbench key script
+	if (const char* KeyScript = getenv("STARFLIGHT_RECORD_KEYS"))
+	{
+		GraphicsRecordKeys(KeyScript);
+	}
+
 	// Start emulator thread
 	gWorker = std::thread([](){
 		SetCurrentThreadName("Starflight Emulator");
@@ -100,12 +120,12 @@ void StartStarflight()
 		SF_LOG(TEXT("Emulator thread terminating (id=%u)"), FPlatformTLS::GetCurrentThreadId());
 	});
 
-	// Start graphics update thread (60Hz)
+	// Start graphics update thread, woken whenever the game publishes a frame
 	gGraphicsThread = std::thread([](){
 		while (gRunning.load(std::memory_order_acquire) && !IsGraphicsShutdown())
 		{
+			GraphicsWaitFrame();
 			GraphicsUpdate();
-			std::this_thread::sleep_for(std::chrono::milliseconds(16)); // ~60 FPS
 		}
 	});
 }
@@ -122,6 +142,10 @@ void StopStarflight()
 	if (gWorker.joinable()) gWorker.join();
 	if (gGraphicsThread.joinable()) gGraphicsThread.join();
 
+	// Flush any pending call trace records
+	EnableCallTrace(false);
+	GraphicsRecordKeys(nullptr);
+
 	// Report that the emulator is now off
 	FStarflightStatus status;
 	status.State = FStarflightEmulatorState::Off;
@@ -131,14 +155,14 @@ void StopStarflight()
 }
 
 // Internal helpers to emit data (call these from emulator thread once wired)
-void EmitFrame(const uint8_t* bgra, int w, int h, int pitch)
+void EmitFrame(const uint8_t* bgra, int w, int h, int pitch, const FStarflightDirtyRect* dirty, int dirtyCount)
 {
 	FrameSinkFn sink;
 	{
 		std::lock_guard<std::mutex> lock(gSinksMutex);
 		sink = gFrameSink;
 	}
-	if (sink) { sink(bgra, w, h, pitch); }
+	if (sink) { sink(bgra, w, h, pitch, dirty, dirtyCount); }
 }
 
 void SetStatusSink(StatusSinkFn cb)
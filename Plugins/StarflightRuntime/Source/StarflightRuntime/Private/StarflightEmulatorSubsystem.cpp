@@ -46,9 +46,9 @@ void UStarflightEmulatorSubsystem::Initialize(FSubsystemCollectionBase& Collecti
 
 	UE_LOG(LogStarflightEmulatorSubsystem, Log, TEXT("StarflightEmulatorSubsystem::Initialize"));
 
-	SetFrameSink([this](const uint8* BGRA, int32 Width, int32 Height, int32 Pitch)
+	SetFrameSink([this](const uint8* BGRA, int32 Width, int32 Height, int32 Pitch, const FStarflightDirtyRect* Dirty, int32 DirtyCount)
 	{
-		HandleFrame(BGRA, Width, Height, Pitch);
+		HandleFrame(BGRA, Width, Height, Pitch, Dirty, DirtyCount);
 	});
 
 	SetRotoscopeSink([this](const uint8* BGRA, int32 Width, int32 Height, int32 Pitch)
@@ -121,8 +121,13 @@ bool UStarflightEmulatorSubsystem::IsEmulatorRunning() const
 FDelegateHandle UStarflightEmulatorSubsystem::RegisterFrameListener(FStarflightFrameCallback&& Callback)
 {
 	const FDelegateHandle Handle(FDelegateHandle::GenerateNewHandle);
-	FScopeLock Lock(&FrameListenersMutex);
-	FrameListeners.Add(FStarflightFrameListenerEntry{ Handle, MoveTemp(Callback) });
+	{
+		FScopeLock Lock(&FrameListenersMutex);
+		FrameListeners.Add(FStarflightFrameListenerEntry{ Handle, MoveTemp(Callback) });
+	}
+
+	// Frames only carry changed rows, and a static screen sends none, so have the whole screen sent again
+	RequestFullFrame();
 	return Handle;
 }
 
@@ -162,9 +167,9 @@ void UStarflightEmulatorSubsystem::UnregisterRotoscopeListener(FDelegateHandle H
 	});
 }
 
-void UStarflightEmulatorSubsystem::HandleFrame(const uint8* BGRA, int32 Width, int32 Height, int32 Pitch)
+void UStarflightEmulatorSubsystem::HandleFrame(const uint8* BGRA, int32 Width, int32 Height, int32 Pitch, const FStarflightDirtyRect* Dirty, int32 DirtyCount)
 {
-	BroadcastFrame(BGRA, Width, Height, Pitch);
+	BroadcastFrame(BGRA, Width, Height, Pitch, Dirty, DirtyCount);
 }
 
 void UStarflightEmulatorSubsystem::HandleRotoscope(const uint8* BGRA, int32 Width, int32 Height, int32 Pitch)
@@ -172,7 +177,7 @@ void UStarflightEmulatorSubsystem::HandleRotoscope(const uint8* BGRA, int32 Widt
 	BroadcastRotoscope(BGRA, Width, Height, Pitch);
 }
 
-void UStarflightEmulatorSubsystem::BroadcastFrame(const uint8* BGRA, int32 Width, int32 Height, int32 Pitch)
+void UStarflightEmulatorSubsystem::BroadcastFrame(const uint8* BGRA, int32 Width, int32 Height, int32 Pitch, const FStarflightDirtyRect* Dirty, int32 DirtyCount)
 {
 	TArray<FStarflightFrameListenerEntry> LocalListeners;
 	{
@@ -184,7 +189,7 @@ void UStarflightEmulatorSubsystem::BroadcastFrame(const uint8* BGRA, int32 Width
 	{
 		if (Entry.Callback)
 		{
-			Entry.Callback(BGRA, Width, Height, Pitch);
+			Entry.Callback(BGRA, Width, Height, Pitch, Dirty, DirtyCount);
 		}
 	}
 }
@@ -32,6 +32,8 @@
 #include "EngineUtils.h"
 #include "Framework/Application/SlateApplication.h"
 
+#include <chrono>
+
 DEFINE_LOG_CATEGORY_STATIC(LogStarflightHUD, Log, All);
 DEFINE_LOG_CATEGORY_STATIC(LogStarflightViewport, Log, All);
 
@@ -79,6 +81,21 @@ IMPLEMENT_GLOBAL_SHADER(FSmallCRTCS, "/Starflight/SmallCRT.usf", "MainCS", SF_Co
 static_assert(SF_OUTPUT_WIDTH == 640, "This HUD assumes 640px output width.");
 static_assert(SF_OUTPUT_HEIGHT == 200 || SF_OUTPUT_HEIGHT == 400, "SF_OUTPUT_HEIGHT must be 200 or 400.");
 
+// RHI texture behind a render target, nullptr until its resource exists. A
+// new one means the target was (re)created and holds none of the frame.
+static FRHITexture* RenderTargetTexture(UTextureRenderTarget2D* Target)
+{
+	FTextureRenderTargetResource* Resource = Target ? Target->GameThread_GetRenderTargetResource() : nullptr;
+	return Resource ? Resource->GetRenderTargetTexture() : nullptr;
+}
+
+// Time since a GetFramePublishTime() value, both on std::chrono::steady_clock
+static double MillisecondsSince(uint64 PublishTime)
+{
+	const uint64 Now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	return (Now - PublishTime) / 1e6;
+}
+
 AStarflightHUD::AStarflightHUD()
 {
 	PrimaryActorTick.bCanEverTick = true;
@@ -112,11 +129,11 @@ void AStarflightHUD::BeginPlay()
 				TWeakObjectPtr<AStarflightHUD> WeakThis(this);
 
 				FrameListenerHandle = Subsystem->RegisterFrameListener(
-					[WeakThis](const uint8* BGRA, int32 W, int32 H, int32 Pitch)
+					[WeakThis](const uint8* BGRA, int32 W, int32 H, int32 Pitch, const FStarflightDirtyRect* Dirty, int32 DirtyCount)
 					{
 						if (AStarflightHUD* StrongHUD = WeakThis.Get())
 						{
-							StrongHUD->OnFrame(BGRA, W, H, Pitch);
+							StrongHUD->OnFrame(BGRA, W, H, Pitch, Dirty, DirtyCount);
 						}
 					});
 
@@ -198,32 +215,40 @@ void AStarflightHUD::EndPlay(const EEndPlayReason::Type EndPlayReason)
     }
 }
 
-void AStarflightHUD::OnFrame(const uint8* BGRA, int W, int H, int Pitch)
+void AStarflightHUD::OnFrame(const uint8* BGRA, int W, int H, int Pitch, const FStarflightDirtyRect* Dirty, int DirtyCount)
 {
 	FScopeLock Lock(&FrameMutex);
+	const bool bResized = W != Width || H != Height || LatestFrame.Num() != W * H * 4;
 	Width = W;
 	Height = H;
 	LatestPitch = Pitch;
+	FramePublishTime = GetFramePublishTime();
 	
 	// Allocate buffer for the frame
 	LatestFrame.SetNum(W * H * 4);
 	
-	// Copy row by row if pitch != width * 4, otherwise copy directly
-	if (Pitch == W * 4)
+	// A new size, or a frame without dirty rects, replaces everything
+	if (bResized || DirtyCount <= 0)
 	{
-		FMemory::Memcpy(LatestFrame.GetData(), BGRA, W * H * 4);
+		for (int y = 0; y < H; ++y)
+		{
+			FMemory::Memcpy(LatestFrame.GetData() + y * W * 4, BGRA + y * Pitch, W * 4);
+		}
+		DirtyMinY = 0;
+		DirtyMaxY = H - 1;
+		return;
 	}
-	else
+
+	// Copy the changed rectangles only, and remember their rows for UpdateTexture
+	for (int i = 0; i < DirtyCount; ++i)
 	{
-		// Copy row by row to handle pitch correctly
-		for (int y = 0; y < H; ++y)
+		const FStarflightDirtyRect& Rect = Dirty[i];
+		for (int y = Rect.Y; y < Rect.Y + Rect.Height; ++y)
 		{
-			FMemory::Memcpy(
-				LatestFrame.GetData() + y * W * 4,
-				BGRA + y * Pitch,
-				W * 4
-			);
+			FMemory::Memcpy(LatestFrame.GetData() + (y * W + Rect.X) * 4, BGRA + y * Pitch + Rect.X * 4, Rect.Width * 4);
 		}
+		DirtyMinY = DirtyMaxY < DirtyMinY ? Rect.Y : FMath::Min(DirtyMinY, Rect.Y);
+		DirtyMaxY = FMath::Max(DirtyMaxY, Rect.Y + Rect.Height - 1);
 	}
 }
 
@@ -232,32 +257,79 @@ void AStarflightHUD::UpdateTexture()
     if (!UpscaledRenderTarget) return;
 
 	TArray<uint8> LocalCopy;
-    int32 LocalW, LocalH;
+    int32 LocalW, LocalH, SrcY0, SrcY1;
+	uint64 PublishTime;
 	{
 		FScopeLock Lock(&FrameMutex);
-		if (LatestFrame.Num() == 0) return;
+		// A render target created or recreated since the last upload has none of the frame
+		if (RenderTargetTexture(UpscaledRenderTarget) != UploadedTexture)
+		{
+			DirtyMinY = 0;
+			DirtyMaxY = Height - 1;
+		}
+		// Nothing arrived since the last upload
+		if (LatestFrame.Num() == 0 || DirtyMaxY < DirtyMinY) return;
 		LocalCopy = LatestFrame;
 		LocalW = Width;
 		LocalH = Height;
+		SrcY0 = DirtyMinY;
+		SrcY1 = DirtyMaxY;
+		PublishTime = FramePublishTime;
+		DirtyMinY = 0;
+		DirtyMaxY = -1;
 	}
 
     // CPU format into a BGRA buffer as configured
     const int32 DstW = SF_OUTPUT_WIDTH;
     const int32 DstH = SF_OUTPUT_HEIGHT;
-    TArray<uint8> Upscaled;
-    Upscaled.SetNumZeroed(DstW * DstH * 4);
+    if (UpscaledFrame.Num() != DstW * DstH * 4)
+    {
+        UpscaledFrame.SetNumZeroed(DstW * DstH * 4);
+    }
 
     // Compute horizontal integer scale to cover 640 exactly for common widths
     // 160 -> 4x, 320 -> 2x, 640 -> 1x
     const int32 ScaleX = FMath::Max(1, DstW / FMath::Max(1, LocalW));
 
-    if (DstH == LocalH)
+    // Destination rows to redo and upload; the fallback scaling redoes all
+    int32 DstY0 = 0;
+    int32 DstY1 = DstH - 1;
+
+    if (LocalW == DstW && (DstH == LocalH || DstH == LocalH * 2))
+    {
+        // Frames arrive at the output width already converted: copy the rows,
+        // once for 640x200, doubled or with a black scanline for 640x400
+        const int32 Factor = DstH / LocalH;
+        DstY0 = SrcY0 * Factor;
+        DstY1 = SrcY1 * Factor + Factor - 1;
+        for (int32 sy = SrcY0; sy <= SrcY1; ++sy)
+        {
+            const uint8* SrcRow = LocalCopy.GetData() + sy * LocalW * 4;
+            uint8* DstRow = UpscaledFrame.GetData() + sy * Factor * DstW * 4;
+            FMemory::Memcpy(DstRow, SrcRow, DstW * 4);
+            if (Factor == 2)
+            {
+#if SF_SCANLINE_BLACK
+                uint32* Scanline = reinterpret_cast<uint32*>(DstRow + DstW * 4);
+                for (int32 dx = 0; dx < DstW; ++dx)
+                {
+                    Scanline[dx] = 0xFF000000u; // opaque black BGRA
+                }
+#else
+                FMemory::Memcpy(DstRow + DstW * 4, SrcRow, DstW * 4);
+#endif
+            }
+        }
+    }
+    else if (DstH == LocalH)
     {
         // 640x200: single line per source row, horizontal integer scaling only
-        for (int32 sy = 0; sy < LocalH; ++sy)
+        DstY0 = SrcY0;
+        DstY1 = SrcY1;
+        for (int32 sy = SrcY0; sy <= SrcY1; ++sy)
         {
             const uint8* SrcRow = LocalCopy.GetData() + sy * LocalW * 4;
-            uint8* DstRow = Upscaled.GetData() + sy * DstW * 4;
+            uint8* DstRow = UpscaledFrame.GetData() + sy * DstW * 4;
 
             for (int32 sx = 0; sx < LocalW; ++sx)
             {
@@ -278,12 +350,14 @@ void AStarflightHUD::UpdateTexture()
     else if (DstH == LocalH * 2)
     {
         // 640x400: either black scanlines or line-doubling
-        for (int32 sy = 0; sy < LocalH; ++sy)
+        DstY0 = SrcY0 * 2;
+        DstY1 = SrcY1 * 2 + 1;
+        for (int32 sy = SrcY0; sy <= SrcY1; ++sy)
         {
             const int32 dy = sy * 2; // even rows
             const uint8* SrcRow = LocalCopy.GetData() + sy * LocalW * 4;
-            uint8* DstRow0 = Upscaled.GetData() + dy * DstW * 4;
-            uint8* DstRow1 = Upscaled.GetData() + (dy + 1) * DstW * 4;
+            uint8* DstRow0 = UpscaledFrame.GetData() + dy * DstW * 4;
+            uint8* DstRow1 = UpscaledFrame.GetData() + (dy + 1) * DstW * 4;
 
             for (int32 sx = 0; sx < LocalW; ++sx)
             {
@@ -323,7 +397,7 @@ void AStarflightHUD::UpdateTexture()
         {
             const int32 sy = FMath::Clamp((dy * LocalH) / FMath::Max(1, DstH), 0, LocalH - 1);
             const uint8* SrcRow = LocalCopy.GetData() + sy * LocalW * 4;
-            uint8* DstRow = Upscaled.GetData() + dy * DstW * 4;
+            uint8* DstRow = UpscaledFrame.GetData() + dy * DstW * 4;
             for (int32 sx = 0; sx < LocalW; ++sx)
             {
                 const uint8* SrcPx = SrcRow + sx * 4;
@@ -360,7 +434,7 @@ void AStarflightHUD::UpdateTexture()
 		{
 			const int32 SrcW = DstW;
 			const int32 SrcH = DstH;
-			PngWriter->SetRaw(Upscaled.GetData(), Upscaled.Num(), SrcW, SrcH, ERGBFormat::BGRA, 8);
+			PngWriter->SetRaw(UpscaledFrame.GetData(), UpscaledFrame.Num(), SrcW, SrcH, ERGBFormat::BGRA, 8);
 
 			const TArray64<uint8>& Compressed64 = PngWriter->GetCompressed(0);
 			TArray<uint8> Compressed;
@@ -379,15 +453,18 @@ void AStarflightHUD::UpdateTexture()
     {
         if (FRHITexture* RHITexture = RTRes->GetRenderTargetTexture())
         {
-            TArray<uint8> BufferCopy = MoveTemp(Upscaled);
+            UploadedTexture = RHITexture;
+            const int32 UploadY = DstY0;
+            const int32 UploadH = DstY1 - DstY0 + 1;
+            TArray<uint8> BufferCopy(UpscaledFrame.GetData() + UploadY * DstW * 4, UploadH * DstW * 4);
             const ERHIFeatureLevel::Type FeatureLevel = GetWorld()->GetFeatureLevel();
             ENQUEUE_RENDER_COMMAND(UpdateCRTTarget)(
-                [RHITexture, BufferCopy = MoveTemp(BufferCopy), FeatureLevel](FRHICommandListImmediate& RHICmdList) mutable
+                [RHITexture, BufferCopy = MoveTemp(BufferCopy), UploadY, UploadH, FeatureLevel](FRHICommandListImmediate& RHICmdList) mutable
                 {
                     if (FRHITexture2D* Tex2D = RHITexture->GetTexture2D())
                     {
                         const uint32 SrcPitch = static_cast<uint32>(SF_OUTPUT_WIDTH) * 4u;
-                        FUpdateTextureRegion2D Region(0, 0, 0, 0, static_cast<uint32>(SF_OUTPUT_WIDTH), static_cast<uint32>(SF_OUTPUT_HEIGHT));
+                        FUpdateTextureRegion2D Region(0, static_cast<uint32>(UploadY), 0, 0, static_cast<uint32>(SF_OUTPUT_WIDTH), static_cast<uint32>(UploadH));
                         RHICmdList.UpdateTexture2D(Tex2D, 0, Region, SrcPitch, BufferCopy.GetData());
 
                         FRDGBuilder GraphBuilder(RHICmdList);
@@ -398,6 +475,7 @@ void AStarflightHUD::UpdateTexture()
                     }
                 }
             );
+            UE_LOG(LogStarflightHUD, VeryVerbose, TEXT("Frame upload queued %.3f ms after publish"), MillisecondsSince(PublishTime));
         }
     }
 
@@ -432,6 +510,7 @@ void AStarflightHUD::FillTextureSolid(const FColor& Color)
     if (FTextureRenderTargetResource* RTRes = UpscaledRenderTarget->GameThread_GetRenderTargetResource())
     {
         FRHITexture* RHITexture = RTRes->GetRenderTargetTexture();
+        UploadedTexture = nullptr; // the frame is painted over, the next UpdateTexture sends every row
         TArray<uint8> BufferCopy = MoveTemp(Bytes);
         const ERHIFeatureLevel::Type FeatureLevel = GetWorld()->GetFeatureLevel();
         ENQUEUE_RENDER_COMMAND(UpdateCRTTargetSolid)(
@@ -788,11 +867,11 @@ void UStarflightViewportComponent::BeginPlay()
 				TWeakObjectPtr<UStarflightViewportComponent> WeakThis(this);
 
 				ComponentFrameListenerHandle = Subsystem->RegisterFrameListener(
-					[WeakThis](const uint8* BGRA, int32 Width, int32 Height, int32 Pitch)
+					[WeakThis](const uint8* BGRA, int32 Width, int32 Height, int32 Pitch, const FStarflightDirtyRect* Dirty, int32 DirtyCount)
 					{
 						if (UStarflightViewportComponent* StrongComponent = WeakThis.Get())
 						{
-							StrongComponent->HandleFrame(BGRA, Width, Height, Pitch);
+							StrongComponent->HandleFrame(BGRA, Width, Height, Pitch, Dirty, DirtyCount);
 						}
 					});
 			}
@@ -840,19 +919,17 @@ void UStarflightViewportComponent::TickComponent(float DeltaTime, enum ELevelTic
 	PushTextureToMID();
 }
 
-void UStarflightViewportComponent::HandleFrame(const uint8* BGRA, int32 InWidth, int32 InHeight, int32 InPitch)
+void UStarflightViewportComponent::HandleFrame(const uint8* BGRA, int32 InWidth, int32 InHeight, int32 InPitch, const FStarflightDirtyRect* Dirty, int32 DirtyCount)
 {
 	FScopeLock Lock(&ComponentFrameMutex);
+	const bool bResized = InWidth != Width || InHeight != Height || LatestFrame.Num() != InWidth * InHeight * 4;
 	Width = InWidth;
 	Height = InHeight;
 	LatestPitch = InPitch;
+	FramePublishTime = GetFramePublishTime();
 	LatestFrame.SetNum(InWidth * InHeight * 4);
 
-	if (InPitch == InWidth * 4)
-	{
-		FMemory::Memcpy(LatestFrame.GetData(), BGRA, LatestFrame.Num());
-	}
-	else
+	if (bResized || DirtyCount <= 0)
 	{
 		for (int32 Row = 0; Row < InHeight; ++Row)
 		{
@@ -860,6 +937,22 @@ void UStarflightViewportComponent::HandleFrame(const uint8* BGRA, int32 InWidth,
 			uint8* Dst = LatestFrame.GetData() + Row * InWidth * 4;
 			FMemory::Memcpy(Dst, Src, InWidth * 4);
 		}
+		DirtyMinY = 0;
+		DirtyMaxY = InHeight - 1;
+		return;
+	}
+
+	for (int32 i = 0; i < DirtyCount; ++i)
+	{
+		const FStarflightDirtyRect& Rect = Dirty[i];
+		for (int32 Row = Rect.Y; Row < Rect.Y + Rect.Height; ++Row)
+		{
+			const uint8* Src = BGRA + Row * InPitch + Rect.X * 4;
+			uint8* Dst = LatestFrame.GetData() + (Row * InWidth + Rect.X) * 4;
+			FMemory::Memcpy(Dst, Src, Rect.Width * 4);
+		}
+		DirtyMinY = DirtyMaxY < DirtyMinY ? Rect.Y : FMath::Min(DirtyMinY, Rect.Y);
+		DirtyMaxY = FMath::Max(DirtyMaxY, Rect.Y + Rect.Height - 1);
 	}
 }
 
@@ -873,34 +966,83 @@ void UStarflightViewportComponent::UpdateTexture()
 	TArray<uint8> LocalCopy;
 	int32 LocalW = 0;
 	int32 LocalH = 0;
+	int32 SrcY0 = 0;
+	int32 SrcY1 = -1;
+	uint64 PublishTime = 0;
 	{
 		FScopeLock Lock(&ComponentFrameMutex);
-		if (LatestFrame.Num() == 0)
+		// A render target created or recreated since the last upload has none of the frame
+		if (RenderTargetTexture(UpscaledRenderTarget) != UploadedTexture)
+		{
+			DirtyMinY = 0;
+			DirtyMaxY = Height - 1;
+		}
+		// Nothing arrived since the last upload
+		if (LatestFrame.Num() == 0 || DirtyMaxY < DirtyMinY)
 		{
 			return;
 		}
 		LocalCopy = LatestFrame;
 		LocalW = Width;
 		LocalH = Height;
+		SrcY0 = DirtyMinY;
+		SrcY1 = DirtyMaxY;
+		PublishTime = FramePublishTime;
+		DirtyMinY = 0;
+		DirtyMaxY = -1;
 	}
 
 	// CPU format into a BGRA buffer as configured
 	const int32 DstW = SF_OUTPUT_WIDTH;
 	const int32 DstH = SF_OUTPUT_HEIGHT;
-	TArray<uint8> Upscaled;
-	Upscaled.SetNumZeroed(DstW * DstH * 4);
+	if (UpscaledFrame.Num() != DstW * DstH * 4)
+	{
+		UpscaledFrame.SetNumZeroed(DstW * DstH * 4);
+	}
 
 	// Compute horizontal integer scale to cover 640 exactly for common widths
 	// 160 -> 4x, 320 -> 2x, 640 -> 1x
 	const int32 ScaleX = FMath::Max(1, DstW / FMath::Max(1, LocalW));
 
-	if (DstH == LocalH)
+	// Destination rows to redo and upload; the fallback scaling redoes all
+	int32 DstY0 = 0;
+	int32 DstY1 = DstH - 1;
+
+	if (LocalW == DstW && (DstH == LocalH || DstH == LocalH * 2))
+	{
+		// Frames arrive at the output width already converted: copy the rows,
+		// once for 640x200, doubled or with a black scanline for 640x400
+		const int32 Factor = DstH / LocalH;
+		DstY0 = SrcY0 * Factor;
+		DstY1 = SrcY1 * Factor + Factor - 1;
+		for (int32 sy = SrcY0; sy <= SrcY1; ++sy)
+		{
+			const uint8* SrcRow = LocalCopy.GetData() + sy * LocalW * 4;
+			uint8* DstRow = UpscaledFrame.GetData() + sy * Factor * DstW * 4;
+			FMemory::Memcpy(DstRow, SrcRow, DstW * 4);
+			if (Factor == 2)
+			{
+#if SF_SCANLINE_BLACK
+				uint32* Scanline = reinterpret_cast<uint32*>(DstRow + DstW * 4);
+				for (int32 dx = 0; dx < DstW; ++dx)
+				{
+					Scanline[dx] = 0xFF000000u; // opaque black BGRA
+				}
+#else
+				FMemory::Memcpy(DstRow + DstW * 4, SrcRow, DstW * 4);
+#endif
+			}
+		}
+	}
+	else if (DstH == LocalH)
 	{
 		// 640x200: single line per source row, horizontal integer scaling only
-		for (int32 sy = 0; sy < LocalH; ++sy)
+		DstY0 = SrcY0;
+		DstY1 = SrcY1;
+		for (int32 sy = SrcY0; sy <= SrcY1; ++sy)
 		{
 			const uint8* SrcRow = LocalCopy.GetData() + sy * LocalW * 4;
-			uint8* DstRow = Upscaled.GetData() + sy * DstW * 4;
+			uint8* DstRow = UpscaledFrame.GetData() + sy * DstW * 4;
 
 			for (int32 sx = 0; sx < LocalW; ++sx)
 			{
@@ -921,12 +1063,14 @@ void UStarflightViewportComponent::UpdateTexture()
 	else if (DstH == LocalH * 2)
 	{
 		// 640x400: mirror HUD behavior (line doubling or black scanlines depending on SF_SCANLINE_BLACK)
-		for (int32 sy = 0; sy < LocalH; ++sy)
+		DstY0 = SrcY0 * 2;
+		DstY1 = SrcY1 * 2 + 1;
+		for (int32 sy = SrcY0; sy <= SrcY1; ++sy)
 		{
 			const int32 dy = sy * 2; // even rows
 			const uint8* SrcRow = LocalCopy.GetData() + sy * LocalW * 4;
-			uint8* DstRow0 = Upscaled.GetData() + dy * DstW * 4;
-			uint8* DstRow1 = Upscaled.GetData() + (dy + 1) * DstW * 4;
+			uint8* DstRow0 = UpscaledFrame.GetData() + dy * DstW * 4;
+			uint8* DstRow1 = UpscaledFrame.GetData() + (dy + 1) * DstW * 4;
 
 			for (int32 sx = 0; sx < LocalW; ++sx)
 			{
@@ -966,7 +1110,7 @@ void UStarflightViewportComponent::UpdateTexture()
 		{
 			const int32 sy = FMath::Clamp((dy * LocalH) / FMath::Max(1, DstH), 0, LocalH - 1);
 			const uint8* SrcRow = LocalCopy.GetData() + sy * LocalW * 4;
-			uint8* DstRow = Upscaled.GetData() + dy * DstW * 4;
+			uint8* DstRow = UpscaledFrame.GetData() + dy * DstW * 4;
 			for (int32 sx = 0; sx < LocalW; ++sx)
 			{
 				const uint8* SrcPx = SrcRow + sx * 4;
@@ -989,15 +1133,18 @@ void UStarflightViewportComponent::UpdateTexture()
 	{
 		if (FRHITexture* RHITexture = RTRes->GetRenderTargetTexture())
 		{
-			TArray<uint8> BufferCopy = MoveTemp(Upscaled);
+			UploadedTexture = RHITexture;
+			const int32 UploadY = DstY0;
+			const int32 UploadH = DstY1 - DstY0 + 1;
+			TArray<uint8> BufferCopy(UpscaledFrame.GetData() + UploadY * DstW * 4, UploadH * DstW * 4);
 			const ERHIFeatureLevel::Type FeatureLevel = GetWorld()->GetFeatureLevel();
 			ENQUEUE_RENDER_COMMAND(UpdateCRTTarget_Viewport)(
-				[RHITexture, BufferCopy = MoveTemp(BufferCopy), FeatureLevel](FRHICommandListImmediate& RHICmdList) mutable
+				[RHITexture, BufferCopy = MoveTemp(BufferCopy), UploadY, UploadH, FeatureLevel](FRHICommandListImmediate& RHICmdList) mutable
 				{
 					if (FRHITexture2D* Tex2D = RHITexture->GetTexture2D())
 					{
 						const uint32 SrcPitch = static_cast<uint32>(SF_OUTPUT_WIDTH) * 4u;
-						FUpdateTextureRegion2D Region(0, 0, 0, 0, static_cast<uint32>(SF_OUTPUT_WIDTH), static_cast<uint32>(SF_OUTPUT_HEIGHT));
+						FUpdateTextureRegion2D Region(0, static_cast<uint32>(UploadY), 0, 0, static_cast<uint32>(SF_OUTPUT_WIDTH), static_cast<uint32>(UploadH));
 						RHICmdList.UpdateTexture2D(Tex2D, 0, Region, SrcPitch, BufferCopy.GetData());
 
 						FRDGBuilder GraphBuilder(RHICmdList);
@@ -1007,6 +1154,7 @@ void UStarflightViewportComponent::UpdateTexture()
 						GraphBuilder.Execute();
 					}
 				});
+			UE_LOG(LogStarflightViewport, VeryVerbose, TEXT("Frame upload queued %.3f ms after publish"), MillisecondsSince(PublishTime));
 		}
 	}
 }
@@ -7,15 +7,34 @@
 STARFLIGHTRUNTIME_API void StartStarflight();
 STARFLIGHTRUNTIME_API void StopStarflight();
 
-// Sinks to receive frames and audio from the emulator
-using FrameSinkFn = std::function<void(const uint8_t* bgra, int width, int height, int pitch)>;
+// Region of a frame that changed since the previous one, in frame pixels
+struct FStarflightDirtyRect
+{
+	int32_t X = 0;
+	int32_t Y = 0;
+	int32_t Width = 0;
+	int32_t Height = 0;
+};
+
+// Sinks to receive frames and audio from the emulator. Frames are only sent
+// when something changed; bgra is always the whole frame, and pixels outside
+// the dirty rects are the same as in the previous frame of that size.
+using FrameSinkFn = std::function<void(const uint8_t* bgra, int width, int height, int pitch, const FStarflightDirtyRect* dirty, int dirtyCount)>;
 using AudioSinkFn = std::function<void(const int16_t* pcm, int frames, int sampleRate, int channels)>;
 
 STARFLIGHTRUNTIME_API void SetFrameSink(FrameSinkFn cb);
 STARFLIGHTRUNTIME_API void SetAudioSink(AudioSinkFn cb);
 
+// Sends the current frame to the frame sink again, whole and without dirty
+// rects, even when the screen is static. For listeners that join late.
+STARFLIGHTRUNTIME_API void RequestFullFrame();
+
+// Inside the frame sink: when the emulator published the frame being sent, in
+// std::chrono::steady_clock nanoseconds. For measuring frame latency.
+STARFLIGHTRUNTIME_API uint64_t GetFramePublishTime();
+
 // Internal helper called by graphics.cpp to emit frames
-STARFLIGHTRUNTIME_API void EmitFrame(const uint8_t* bgra, int w, int h, int pitch);
+STARFLIGHTRUNTIME_API void EmitFrame(const uint8_t* bgra, int w, int h, int pitch, const FStarflightDirtyRect* dirty, int dirtyCount);
 
 // Optional rotoscope debug stream (160x200 BGRA)
 using RotoscopeSinkFn = std::function<void(const uint8_t* bgra, int width, int height, int pitch)>;
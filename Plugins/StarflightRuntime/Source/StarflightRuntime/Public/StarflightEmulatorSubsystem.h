@@ -11,7 +11,7 @@
 
 class UStarflightEmulatorSubsystem;
 
-using FStarflightFrameCallback = TFunction<void(const uint8*, int32, int32, int32)>;
+using FStarflightFrameCallback = TFunction<void(const uint8*, int32, int32, int32, const FStarflightDirtyRect*, int32)>;
 using FStarflightRotoscopeCallback = TFunction<void(const uint8*, int32, int32, int32)>;
 using FStarflightSpaceManCallback = TFunction<void(uint16, uint16)>;
 
@@ -62,11 +62,11 @@ private:
 		FStarflightSpaceManCallback Callback;
 	};
 
-	void HandleFrame(const uint8* BGRA, int32 Width, int32 Height, int32 Pitch);
+	void HandleFrame(const uint8* BGRA, int32 Width, int32 Height, int32 Pitch, const FStarflightDirtyRect* Dirty, int32 DirtyCount);
 	void HandleRotoscope(const uint8* BGRA, int32 Width, int32 Height, int32 Pitch);
 	void HandleSpaceManMove(uint16 PixelX, uint16 PixelY);
 
-	void BroadcastFrame(const uint8* BGRA, int32 Width, int32 Height, int32 Pitch);
+	void BroadcastFrame(const uint8* BGRA, int32 Width, int32 Height, int32 Pitch, const FStarflightDirtyRect* Dirty, int32 DirtyCount);
 	void BroadcastRotoscope(const uint8* BGRA, int32 Width, int32 Height, int32 Pitch);
 	void BroadcastSpaceManMove(uint16 PixelX, uint16 PixelY);
 
@@ -11,6 +11,8 @@ class UMaterialInstanceDynamic;
 class UMeshComponent;
 class UTextureRenderTarget2D;
 class UStarflightEmulatorSubsystem;
+class FRHITexture;
+struct FStarflightDirtyRect;
 
 UCLASS()
 class STARFLIGHTRUNTIME_API AStarflightHUD : public AHUD
@@ -43,6 +45,11 @@ private:
 	int32 LatestPitch = 0;
 	int32 Width = 640;
 	int32 Height = 360;
+	// Source rows changed since the last UpdateTexture, empty when DirtyMaxY < DirtyMinY
+	int32 DirtyMinY = 0;
+	int32 DirtyMaxY = -1;
+	// GetFramePublishTime() of the newest frame, for the latency UpdateTexture logs
+	uint64 FramePublishTime = 0;
 	bool bDebugAlternating = false;
 	uint64 FrameCounter = 0;
 	uint32 DumpCounter = 0;
@@ -57,7 +64,7 @@ private:
 	TWeakObjectPtr<UMeshComponent> ScreenMesh;
 	int32 ScreenElementIndex = 0;
 
-    void OnFrame(const uint8* BGRA, int W, int H, int Pitch);
+    void OnFrame(const uint8* BGRA, int W, int H, int Pitch, const FStarflightDirtyRect* Dirty, int DirtyCount);
     void UpdateTexture();
 	void FillTextureSolid(const FColor& Color);
 	void TryBindScreenMID();
@@ -67,6 +74,11 @@ private:
     // Intermediate 640x400 CPU-upscaled texture used for blitting to the RT
     UTexture2D* UpscaledIntermediateTexture = nullptr;
 
+    // CPU upscale of LatestFrame; only changed rows are redone and uploaded
+    TArray<uint8> UpscaledFrame;
+    // Texture of UpscaledRenderTarget the last rows went to; any other means every row is owed
+    FRHITexture* UploadedTexture = nullptr;
+
 	// Rotoscope 160x200 debug overlay
 	FCriticalSection RotoMutex;
 	TArray<uint8> LatestRoto;
@@ -111,7 +123,7 @@ public:
 	FName ScreenMaterialName = TEXT("Screen_WithPlugin");
 
 protected:
-	void HandleFrame(const uint8* BGRA, int32 InWidth, int32 InHeight, int32 InPitch);
+	void HandleFrame(const uint8* BGRA, int32 InWidth, int32 InHeight, int32 InPitch, const FStarflightDirtyRect* Dirty, int32 DirtyCount);
 	void UpdateTexture();
 	void GenerateCRT6x6();
 
@@ -124,11 +136,21 @@ private:
 	int32 LatestPitch = 0;
 	int32 Width = 640;
 	int32 Height = 360;
+	// Source rows changed since the last UpdateTexture, empty when DirtyMaxY < DirtyMinY
+	int32 DirtyMinY = 0;
+	int32 DirtyMaxY = -1;
+	// GetFramePublishTime() of the newest frame, for the latency UpdateTexture logs
+	uint64 FramePublishTime = 0;
 	uint64 FrameCounter = 0;
 
 	// Intermediate 640x400 CPU-upscaled texture used for blitting to the RT
 	UTexture2D* UpscaledIntermediateTexture = nullptr;
 
+	// CPU upscale of LatestFrame; only changed rows are redone and uploaded
+	TArray<uint8> UpscaledFrame;
+	// Texture of UpscaledRenderTarget the last rows went to; any other means every row is owed
+	FRHITexture* UploadedTexture = nullptr;
+
 	// Runtime binding to a mesh using the Screen material
 	TWeakObjectPtr<UMaterialInstanceDynamic> ScreenMID;
 	TWeakObjectPtr<UMeshComponent> ScreenMesh;
@@ -0,0 +1,173 @@
+// blitrow - GraphicsBlitRow against the per-pixel blit it replaced
+//
+// Build:  see Plugins/StarflightRuntime/CMakeLists.txt
+// Usage:  blitrow [cases]
+//
+// GraphicsBlitRow blends 8 pixels at a time and writes the rotoscope planes a
+// row at a time. The reference below is the loop it replaced, one GraphicsPeek
+// and GraphicsPixel per pixel. Every case fills the rows around the blit with
+// random pixels and rotoscope data, runs one of the two, and reads the rows
+// back through GraphicsPeek. Images, positions (also off the page), colors,
+// contents and XOR mode are random; XOR over text pixels is the case that
+// keeps the glyph and flips its colors.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "context.h"
+#include "graphics.h"
+
+static constexpr int Width = 160;
+static constexpr int Height = 200;
+static constexpr uint32_t Page = 0xA000;
+
+static std::mt19937 s_rng;
+
+static uint32_t Random(uint32_t n)
+{
+    return s_rng() % n;
+}
+
+static void ReferenceBlitRow(int y, int x0, int w, const uint16_t* image, int bit, int color, int xormode, uint32_t offset, const Rotoscope& pc)
+{
+    for (int i = 0; i < w; ++i, ++bit)
+    {
+        const int x = x0 + i;
+        if (x < 0 || x >= Width || y < 0 || y >= Height)
+        {
+            continue;
+        }
+
+        const bool set = (image[bit >> 4] & (0x8000 >> (bit & 15))) != 0;
+        Rotoscope old;
+        const uint8_t src = GraphicsPeek(x, y, offset, &old);
+        if (set && xormode && old.content == TextPixel)
+        {
+            old.fgColor ^= color;
+            old.bgColor ^= color;
+            GraphicsPixel(x, y, src ^ color, offset, old);
+            continue;
+        }
+
+        Rotoscope rs = pc;
+        rs.bgColor = pc.content == TextPixel ? src : pc.bgColor;
+        rs.blt_x = pc.blt_x + i;
+        GraphicsPixel(x, y, !set ? src : xormode ? src ^ color : color, offset, rs);
+    }
+}
+
+static Rotoscope RandomRotoscope(PixelContents content)
+{
+    Rotoscope rs(content);
+    rs.fgColor = (uint8_t)s_rng();
+    rs.bgColor = (uint8_t)s_rng();
+    rs.blt_x = (int16_t)s_rng();
+    rs.blt_y = (int16_t)s_rng();
+    rs.blt_w = Random(64);
+    rs.blt_h = Random(64);
+    rs.textData.fontNum = Random(3);
+    rs.textData.character = (char)('A' + Random(26));
+    rs.textData.xormode = Random(2);
+    rs.picData.picID = Random(4);
+    return rs;
+}
+
+static void FillRows(int y0, int y1)
+{
+    static const PixelContents contents[] = { ClearPixel, NavigationalPixel, TextPixel, TextPixel, EllipsePixel, BoxFillPixel, PicPixel, RunBitPixel };
+    for (int y = y0; y <= y1; ++y)
+    {
+        for (int x = 0; x < Width; ++x)
+        {
+            GraphicsPixel(x, y, Random(16), Page, RandomRotoscope(contents[Random(sizeof(contents) / sizeof(contents[0]))]));
+        }
+    }
+}
+
+struct PixelRecord
+{
+    int color, content, fg, bg, bltX, bltY, bltW, bltH, fontNum, character, xormode, picID;
+
+    bool operator==(const PixelRecord&) const = default;
+};
+
+static std::vector<PixelRecord> ReadRows(int y0, int y1)
+{
+    std::vector<PixelRecord> pixels;
+    for (int y = y0; y <= y1; ++y)
+    {
+        for (int x = 0; x < Width; ++x)
+        {
+            Rotoscope rs;
+            const int color = GraphicsPeek(x, y, Page, &rs);
+            pixels.push_back({ color, rs.content, rs.fgColor, rs.bgColor, rs.blt_x, rs.blt_y, rs.blt_w, rs.blt_h,
+                rs.textData.fontNum, rs.textData.character, rs.textData.xormode, (int)rs.picData.picID });
+        }
+    }
+    return pixels;
+}
+
+int main(int argc, char** argv)
+{
+    const int cases = argc > 1 ? atoi(argv[1]) : 2000;
+
+    EmulatorContext::Current();
+    GraphicsInit();
+
+    static const PixelContents blitContents[] = { NavigationalPixel, TextPixel, PicPixel, RunBitPixel };
+    for (int n = 0; n < cases; ++n)
+    {
+        s_rng.seed(n);
+        const int y = (int)Random(Height + 4) - 2;
+        const int x0 = (int)Random(Width + 80) - 40;
+        const int w = 1 + Random(96);
+        const int bit = Random(16);
+        const int color = Random(16);
+        const int xormode = Random(2);
+        const Rotoscope pc = RandomRotoscope(blitContents[Random(sizeof(blitContents) / sizeof(blitContents[0]))]);
+        std::vector<uint16_t> image(8);
+        for (uint16_t& word : image)
+        {
+            // Sparse, dense and random images
+            const uint32_t kind = Random(3);
+            word = kind == 0 ? (uint16_t)(s_rng() & s_rng()) : kind == 1 ? (uint16_t)(s_rng() | s_rng()) : (uint16_t)s_rng();
+        }
+
+        const int y0 = std::max(0, y - 1);
+        const int y1 = std::min(Height - 1, y + 1);
+        const uint32_t fillSeed = s_rng();
+
+        s_rng.seed(fillSeed);
+        FillRows(y0, y1);
+        ReferenceBlitRow(y, x0, w, image.data(), bit, color, xormode, Page, pc);
+        const std::vector<PixelRecord> expected = ReadRows(y0, y1);
+
+        s_rng.seed(fillSeed);
+        FillRows(y0, y1);
+        GraphicsBlitRow(y, x0, w, image.data(), bit, color, xormode, Page, pc);
+        const std::vector<PixelRecord> actual = ReadRows(y0, y1);
+
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            if (expected[i] == actual[i])
+            {
+                continue;
+            }
+
+            const PixelRecord& e = expected[i];
+            const PixelRecord& a = actual[i];
+            fprintf(stderr, "case %d: y %d x0 %d w %d bit %d color %d xor %d content %d\n", n, y, x0, w, bit, color, xormode, (int)pc.content);
+            fprintf(stderr, "  pixel (%d, %d) expected color %d content %d fg %d bg %d blt %d,%d %dx%d font %d char %d xor %d pic %d\n",
+                (int)(i % Width), y0 + (int)(i / Width), e.color, e.content, e.fg, e.bg, e.bltX, e.bltY, e.bltW, e.bltH, e.fontNum, e.character, e.xormode, e.picID);
+            fprintf(stderr, "  pixel (%d, %d) actual   color %d content %d fg %d bg %d blt %d,%d %dx%d font %d char %d xor %d pic %d\n",
+                (int)(i % Width), y0 + (int)(i / Width), a.color, a.content, a.fg, a.bg, a.bltX, a.bltY, a.bltW, a.bltH, a.fontNum, a.character, a.xormode, a.picID);
+            return 1;
+        }
+    }
+
+    printf("%d cases identical\n", cases);
+    return 0;
+}
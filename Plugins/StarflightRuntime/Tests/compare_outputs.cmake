@@ -0,0 +1,43 @@
+# Runs two test programs with the same arguments and fails on the first line
+# where their output differs.
+#
+#   cmake -DREFERENCE=<exe> -DCANDIDATE=<exe> [-DARGS=<args>] -P compare_outputs.cmake
+
+foreach(var REFERENCE CANDIDATE)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "compare_outputs.cmake: ${var} is not set")
+    endif()
+endforeach()
+
+separate_arguments(args NATIVE_COMMAND "${ARGS}")
+
+execute_process(COMMAND ${REFERENCE} ${args} OUTPUT_VARIABLE reference RESULT_VARIABLE reference_result)
+execute_process(COMMAND ${CANDIDATE} ${args} OUTPUT_VARIABLE candidate RESULT_VARIABLE candidate_result)
+
+if(NOT reference_result EQUAL 0 OR NOT candidate_result EQUAL 0)
+    message(FATAL_ERROR "exit codes: ${REFERENCE} ${reference_result}, ${CANDIDATE} ${candidate_result}")
+endif()
+
+if(reference STREQUAL candidate)
+    string(REGEX MATCHALL "\n" lines "${reference}")
+    list(LENGTH lines count)
+    message(STATUS "${count} lines identical")
+    return()
+endif()
+
+string(REPLACE "\n" ";" reference_lines "${reference}")
+string(REPLACE "\n" ";" candidate_lines "${candidate}")
+list(LENGTH reference_lines reference_count)
+list(LENGTH candidate_lines candidate_count)
+
+set(index 0)
+while(index LESS reference_count AND index LESS candidate_count)
+    list(GET reference_lines ${index} reference_line)
+    list(GET candidate_lines ${index} candidate_line)
+    if(NOT reference_line STREQUAL candidate_line)
+        message(FATAL_ERROR "line ${index} differs\n  reference: ${reference_line}\n  candidate: ${candidate_line}")
+    endif()
+    math(EXPR index "${index} + 1")
+endwhile()
+
+message(FATAL_ERROR "output lengths differ: ${reference_count} against ${candidate_count} lines")
@@ -0,0 +1,298 @@
+// cpuflags - flag conformance cases for the 8086 core
+//
+// Build:  see Plugins/StarflightRuntime/CMakeLists.txt
+// Usage:  cpuflags [cases-per-op]
+//
+// The same source is built twice, once with the lazy flags of 8086emu.cpp and
+// once with SF_8086_LAZY_FLAGS=0, the eager update they replace. Every case runs
+// one or two ALU, shift, BCD or string compare instructions on random operands
+// and random input flags, optionally followed by an instruction that reads the
+// flags (Jcc, LOOPZ/LOOPNZ, INTO, PUSHF, LAHF, ADC), and prints the registers,
+// the memory operand and all nine flags afterwards. ALU instructions run on
+// registers and on a word in memory; CMPS/SCAS run alone and under REPZ/REPNZ,
+// so the flags left behind by the bulk REP path are compared too. The
+// cpu8086_lazy_flags test compares the output of both builds line by line
+// (Tests/compare_outputs.cmake).
+//
+// The core runs on a register file and memory of its own here, so nothing but
+// 8086emu.cpp is linked.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <initializer_list>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "cpu.h"
+
+// Forth registers Run8086() reads and writes back, normally in cpu.cpp
+thread_local unsigned short regsi = 0;
+thread_local unsigned short regbp = 0;
+
+static constexpr uint16_t CodeSegment = 0x1000;
+static constexpr uint16_t DataSegment = 0x2000;
+static constexpr uint16_t ExtraSegment = 0x2800;
+static constexpr uint16_t StackSegment = 0x3000;
+
+// Word the memory forms operate on, and the CMPS/SCAS buffers at DS:StringSource and ES:StringDest
+static constexpr uint16_t MemoryOperand = 0x0100;
+static constexpr uint16_t StringSource = 0x0200;
+static constexpr uint16_t StringDest = 0x0400;
+static constexpr int StringBytes = 128;
+
+// Register file offsets, see cpu8086state.h
+enum { RegAX = 0, RegCX = 1, RegDX = 2, RegBX = 3, RegDI = 7, RegES = 8 };
+static constexpr int FlagCF = 40;
+static const char s_flagNames[] = "CPAZSTIDO";
+
+static std::mt19937 s_rng;
+
+static uint32_t Random(uint32_t n)
+{
+    return s_rng() % n;
+}
+
+// Mostly random operands, with the values where carries and overflows change
+static uint16_t RandomOperand()
+{
+    static const uint16_t edges[] = { 0x0000, 0x0001, 0x000F, 0x0010, 0x007F, 0x0080, 0x00FF, 0x0100, 0x7FFF, 0x8000, 0xFFFF, 0xFFFE };
+    return Random(3) == 0 ? edges[Random(sizeof(edges) / sizeof(edges[0]))] : (uint16_t)s_rng();
+}
+
+// Emits opcode with a ModRM byte that addresses the word at DS:MemoryOperand, either directly or
+// as [SI+disp8] after a MOV SI, followed by imm
+static void EmitMemoryForm(std::vector<uint8_t>& code, uint8_t opcode, uint8_t reg, std::initializer_list<uint8_t> imm = {})
+{
+    if (Random(2))
+    {
+        code.insert(code.end(), { opcode, (uint8_t)(reg << 3 | 6), (uint8_t)MemoryOperand, (uint8_t)(MemoryOperand >> 8) });
+    }
+    else
+    {
+        const uint8_t disp = (uint8_t)Random(128);
+        const uint16_t si = MemoryOperand - disp;
+        code.insert(code.end(), { 0xBE, (uint8_t)si, (uint8_t)(si >> 8), opcode, (uint8_t)(0x40 | reg << 3 | 4), disp });
+    }
+    code.insert(code.end(), imm);
+}
+
+// Emits one flag-writing instruction operating on AL/AX with BL/BX, CL or an immediate, on the
+// memory operand, or on the string buffers
+static void EmitFlagOp(std::vector<uint8_t>& code, int op)
+{
+    const uint8_t w = (uint8_t)Random(2);
+    const uint8_t alu = (uint8_t)Random(8); // ADD OR ADC SBB AND SUB XOR CMP
+    switch (op)
+    {
+    case 0: // ALU AL/AX, BL/BX
+        code.insert(code.end(), { (uint8_t)(alu * 8 + w), 0xD8 });
+        break;
+    case 1: // ALU AL/AX, imm
+        code.push_back((uint8_t)(alu * 8 + 4 + w));
+        code.push_back((uint8_t)s_rng());
+        if (w) code.push_back((uint8_t)s_rng());
+        break;
+    case 2: // ALU r/m, imm8 sign extended
+        code.insert(code.end(), { 0x83, (uint8_t)(0xC0 | alu << 3), (uint8_t)s_rng() });
+        break;
+    case 3: // INC|DEC AL/AX, INC|DEC BX
+        if (Random(2))
+            code.insert(code.end(), { (uint8_t)(0xFE + w), (uint8_t)(0xC0 | Random(2) << 3) });
+        else
+            code.push_back((uint8_t)(0x43 + 8 * Random(2)));
+        break;
+    case 4: // NOT|NEG|MUL|IMUL BL/BX
+        code.insert(code.end(), { (uint8_t)(0xF6 + w), (uint8_t)(0xC3 | (2 + Random(4)) << 3) });
+        break;
+    case 5: // TEST
+        if (Random(2))
+            code.insert(code.end(), { (uint8_t)(0x84 + w), 0xD8 });
+        else
+        {
+            code.push_back((uint8_t)(0xA8 + w));
+            code.push_back((uint8_t)s_rng());
+            if (w) code.push_back((uint8_t)s_rng());
+        }
+        break;
+    case 6: // ROL ROR RCL RCR SHL SHR SAR by 1 or CL (C0/C1 are RET on the 8086)
+    {
+        uint8_t sub = (uint8_t)Random(8);
+        if (sub == 6) sub = 7;
+        code.insert(code.end(), { (uint8_t)(0xD0 + 2 * Random(2) + w), (uint8_t)(0xC0 | sub << 3) });
+        break;
+    }
+    case 7: // DAA DAS AAA AAS
+    {
+        static const uint8_t bcd[] = { 0x27, 0x2F, 0x37, 0x3F };
+        code.push_back(bcd[Random(4)]);
+        break;
+    }
+    case 8: // AAM imm8 (not 0) | AAD imm8
+        code.insert(code.end(), { (uint8_t)(0xD4 + Random(2)), (uint8_t)(1 + Random(255)) });
+        break;
+    case 9: // SAHF | CMC | CLC | STC
+    {
+        static const uint8_t flags[] = { 0x9E, 0xF5, 0xF8, 0xF9 };
+        code.push_back(flags[Random(4)]);
+        break;
+    }
+    case 10: // The same groups with the memory operand as r/m
+    {
+        const uint8_t imm = (uint8_t)s_rng();
+        switch (Random(6))
+        {
+        case 0: EmitMemoryForm(code, (uint8_t)(alu * 8 + 2 * Random(2) + w), (uint8_t)Random(4)); break; // ALU r/m, reg | reg, r/m
+        case 1: // ALU r/m, imm
+            if (w && Random(2))
+                EmitMemoryForm(code, 0x81, alu, { imm, (uint8_t)s_rng() });
+            else
+                EmitMemoryForm(code, w ? 0x83 : 0x80, alu, { imm });
+            break;
+        case 2: EmitMemoryForm(code, (uint8_t)(0xFE + w), (uint8_t)Random(2)); break; // INC|DEC
+        case 3: EmitMemoryForm(code, (uint8_t)(0xF6 + w), (uint8_t)(2 + Random(4))); break; // NOT|NEG|MUL|IMUL
+        case 4: // Shifts and rotates by 1 or CL
+        {
+            uint8_t sub = (uint8_t)Random(8);
+            if (sub == 6) sub = 7;
+            EmitMemoryForm(code, (uint8_t)(0xD0 + 2 * Random(2) + w), sub);
+            break;
+        }
+        default: // TEST r/m, reg | TEST r/m, imm
+            if (Random(2))
+                EmitMemoryForm(code, (uint8_t)(0x84 + w), (uint8_t)Random(4));
+            else if (w)
+                EmitMemoryForm(code, 0xF7, 0, { imm, (uint8_t)s_rng() });
+            else
+                EmitMemoryForm(code, 0xF6, 0, { imm });
+            break;
+        }
+        break;
+    }
+    default: // CMPSx | SCASx, alone or under REPZ/REPNZ
+    {
+        const uint16_t si = StringSource + Random(8);
+        const uint16_t di = StringDest + Random(8);
+        code.insert(code.end(), { 0xBE, (uint8_t)si, (uint8_t)(si >> 8), 0xBF, (uint8_t)di, (uint8_t)(di >> 8) });
+        if (Random(4))
+        {
+            const uint16_t cx = (uint16_t)Random(StringBytes / 2 - 8);
+            code.insert(code.end(), { 0xB9, (uint8_t)cx, (uint8_t)(cx >> 8) });
+        }
+        const uint32_t prefix = Random(3);
+        if (prefix)
+            code.push_back((uint8_t)(0xF1 + prefix)); // REPNZ | REPZ
+        code.push_back((uint8_t)((Random(2) ? 0xA6 : 0xAE) + w));
+        break;
+    }
+    }
+}
+
+// Emits an instruction that reads the flags, so they are materialized in the middle of a case
+static void EmitFlagReader(std::vector<uint8_t>& code)
+{
+    switch (Random(6))
+    {
+    case 0: // Jcc over INC DX
+        code.insert(code.end(), { (uint8_t)(0x70 + Random(16)), 0x01, 0x42 });
+        break;
+    case 4: // LOOPNZ | LOOPZ | JCXZ over INC DX
+    {
+        static const uint8_t loops[] = { 0xE0, 0xE1, 0xE3 };
+        code.insert(code.end(), { loops[Random(3)], 0x01, 0x42 });
+        break;
+    }
+    case 5: // INTO, the interrupt stub reports when OF is set
+        code.push_back(0xCE);
+        break;
+    case 1: // PUSHF, POP CX
+        code.insert(code.end(), { 0x9C, 0x59 });
+        break;
+    case 2: // LAHF
+        code.push_back(0x9F);
+        break;
+    default: // ADC DX, imm8
+        code.insert(code.end(), { 0x83, 0xD2, (uint8_t)s_rng() });
+        break;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int casesPerOp = argc > 1 ? atoi(argv[1]) : 2000;
+    static const int opCount = 12;
+
+    std::unique_ptr<uint8_t[]> memory(new uint8_t[SystemMemorySize]());
+    std::unique_ptr<uint8_t[]> ioPorts(new uint8_t[0x10000]());
+    static uint8_t biosTables[20][256];
+    static Cpu8086State state;
+
+    Bind8086(memory.get(), ioPorts.get(), biosTables, &state);
+    Init8086();
+
+    uint8_t* const code = &memory[CodeSegment << 4];
+    uint8_t* const data = &memory[DataSegment << 4];
+    uint8_t* const extra = &memory[ExtraSegment << 4];
+    static const uint8_t next[] = { 0xAD, 0x8B, 0xD8, 0xFF, 0x27 }; // lodsw; mov bx,ax; jmp [bx]
+
+    for (int op = 0; op < opCount; op++)
+    {
+        for (int i = 0; i < casesPerOp; i++)
+        {
+            s_rng.seed(op * 1000003u + i);
+
+            std::vector<uint8_t> program;
+            EmitFlagOp(program, op);
+            switch (Random(4))
+            {
+            case 0: EmitFlagOp(program, Random(opCount)); break;
+            case 1: EmitFlagReader(program); break;
+            case 2: EmitFlagOp(program, Random(opCount)); EmitFlagReader(program); break;
+            default: break;
+            }
+            program.insert(program.end(), next, next + sizeof(next));
+            memcpy(code, program.data(), program.size());
+
+            // Mostly equal string buffers from a few byte values, so REPZ runs on and SCAS finds AL
+            static const uint8_t alphabet[] = { 0x00, 0x01, 0x7F, 0xFF };
+            for (int b = 0; b < StringBytes; b++)
+                data[StringSource + b] = extra[StringDest + b] = alphabet[Random(4)];
+            for (uint32_t k = Random(4); k; k--)
+                extra[StringDest + Random(StringBytes)] = alphabet[Random(4)];
+            const uint16_t operand = RandomOperand();
+            memcpy(&data[MemoryOperand], &operand, 2);
+            regsi = 0;
+
+            state.regs16[RegES] = ExtraSegment;
+            state.regs16[RegAX] = RandomOperand();
+            state.regs16[RegBX] = RandomOperand();
+            state.regs16[RegCX] = Random(2) ? RandomOperand() : Random(20); // shift counts around 8 and 16
+            state.regs16[RegDX] = RandomOperand();
+            for (int f = 0; f < 9; f++)
+            {
+                // No trap or interrupt flag, they would fire the emulator's interrupt stubs
+                state.regs8[FlagCF + f] = (f == 5 || f == 6) ? 0 : (uint8_t)Random(2);
+            }
+
+            printf("%d.%d", op, i);
+            for (uint8_t byte : program)
+                printf(" %02x", byte);
+            printf(" in ax=%04x bx=%04x cx=%04x dx=%04x m=%04x ", state.regs16[RegAX], state.regs16[RegBX], state.regs16[RegCX], state.regs16[RegDX], operand);
+            for (int f = 0; f < 9; f++)
+                putchar(state.regs8[FlagCF + f] ? s_flagNames[f] : '-');
+
+            uint16_t sp = 0xFFF0;
+            Run8086(CodeSegment, 0, DataSegment, StackSegment, &sp);
+
+            uint16_t result;
+            memcpy(&result, &data[MemoryOperand], 2);
+            printf(" out ax=%04x bx=%04x cx=%04x dx=%04x si=%04x di=%04x m=%04x ", state.regs16[RegAX], state.regs16[RegBX], state.regs16[RegCX], state.regs16[RegDX],
+                regsi, state.regs16[RegDI], result);
+            for (int f = 0; f < 9; f++)
+                putchar(state.regs8[FlagCF + f] ? s_flagNames[f] : '-');
+            putchar('\n');
+        }
+    }
+    return 0;
+}
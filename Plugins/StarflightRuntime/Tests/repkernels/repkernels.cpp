@@ -0,0 +1,193 @@
+// repkernels - REP string kernels of the 8086 core against the plain REP loop
+//
+// Build:  see Plugins/StarflightRuntime/CMakeLists.txt
+// Usage:  repkernels [cases]
+//
+// The same source is built twice, once with the bulk REP kernels of 8086emu.cpp
+// (rep_store_bulk, rep_compare_skip) and once with SF_8086_REP_KERNELS=0, the
+// one element at a time loop they shortcut. Every case runs one REP MOVSx,
+// STOSx, CMPSx or SCASx and prints CX, SI, DI, AX, the flags and a checksum of
+// the data segment. The cases aim at the edges of the kernels: overlapping
+// moves (destination one byte above the source, also for words), STOSW with
+// AL != AH, SI or DI running into the 0xFFFF wrap, CX of 0 and 1, DF set, and
+// REPZ/REPNZ compares that stop on the first element, on the last one or not
+// at all. The cpu8086_rep_kernels test compares the output of both builds line
+// by line (Tests/compare_outputs.cmake).
+//
+// The core runs on a register file and memory of its own here, so nothing but
+// 8086emu.cpp is linked.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <memory>
+#include <random>
+
+#include "cpu.h"
+
+// Forth registers Run8086() reads and writes back, normally in cpu.cpp
+thread_local unsigned short regsi = 0;
+thread_local unsigned short regbp = 0;
+
+static constexpr uint16_t CodeSegment = 0x1000;
+static constexpr uint16_t DataSegment = 0x2000;
+static constexpr uint16_t StackSegment = 0x3000;
+
+// Register file offsets, see cpu8086state.h
+enum { RegAX = 0, RegCX = 1, RegDI = 7, RegES = 8 };
+static constexpr int FlagCF = 40;
+static constexpr int FlagDF = 47;
+static const char s_flagNames[] = "CPAZSTIDO";
+
+static std::mt19937 s_rng;
+
+static uint32_t Random(uint32_t n)
+{
+    return s_rng() % n;
+}
+
+// FNV-1a over a 64 KB segment
+static uint32_t Checksum(const uint8_t* segment)
+{
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < 0x10000; i++)
+        hash = (hash ^ segment[i]) * 16777619u;
+    return hash;
+}
+
+int main(int argc, char** argv)
+{
+    const int cases = argc > 1 ? atoi(argv[1]) : 4000;
+
+    std::unique_ptr<uint8_t[]> memory(new uint8_t[SystemMemorySize]());
+    std::unique_ptr<uint8_t[]> ioPorts(new uint8_t[0x10000]());
+    static uint8_t biosTables[20][256];
+    static Cpu8086State state;
+
+    Bind8086(memory.get(), ioPorts.get(), biosTables, &state);
+    Init8086();
+
+    uint8_t* const code = &memory[CodeSegment << 4];
+    uint8_t* const data = &memory[DataSegment << 4];
+    static const uint8_t next[] = { 0xAD, 0x8B, 0xD8, 0xFF, 0x27 }; // lodsw; mov bx,ax; jmp [bx]
+    static const uint8_t opcodes[] = { 0xA4, 0xAA, 0xA6, 0xAE }; // MOVSB, STOSB, CMPSB, SCASB, +1 for words
+
+    for (int n = 0; n < cases; n++)
+    {
+        s_rng.seed(n);
+
+        const uint8_t kind = (uint8_t)Random(4);
+        const uint8_t w = (uint8_t)Random(2);
+        const uint8_t opcode = (uint8_t)(opcodes[kind] + w);
+        const uint8_t prefix = Random(2) ? 0xF3 : 0xF2; // REPZ | REPNZ, both plain REP for MOVS and STOS
+        const uint32_t size = w + 1u;
+        const bool backward = Random(8) == 0;
+
+        uint16_t cx;
+        switch (Random(5))
+        {
+        case 0: cx = (uint16_t)Random(3); break;
+        case 1: cx = (uint16_t)(3 + Random(14)); break;
+        case 2: cx = (uint16_t)(16 + Random(1024)); break;
+        case 3: cx = (uint16_t)(0x100 * (1 + Random(16))); break;
+        default: cx = (uint16_t)s_rng(); break;
+        }
+        const uint32_t bytes = cx * size;
+
+        uint16_t si = (uint16_t)s_rng();
+        uint16_t di = (uint16_t)s_rng();
+        switch (Random(6))
+        {
+        case 0: // Destination one byte above the source: the forward copy repeats the first byte
+            di = si + 1;
+            break;
+        case 1: // Destination one element below or above the source
+            di = Random(2) ? si - size : si + size;
+            break;
+        case 2: // DI ends just before, at or just after the segment end
+            di = (uint16_t)(0x10000 - bytes + Random(5) - 2);
+            break;
+        case 3: // SI ends just before, at or just after the segment end
+            si = (uint16_t)(0x10000 - bytes + Random(5) - 2);
+            break;
+        case 4: // DI starts on the last bytes of the segment
+            di = (uint16_t)(0xFFFF - Random(4));
+            break;
+        default:
+            break;
+        }
+
+        // AL != AH most of the time, so a word store is not a byte fill
+        uint16_t ax = (uint16_t)s_rng();
+        if (Random(4) == 0)
+            ax = (uint16_t)((ax & 0xFF) * 0x101);
+
+        for (uint32_t i = 0; i < 0x10000; i += 4)
+        {
+            const uint32_t value = s_rng();
+            memcpy(&data[i], &value, 4);
+        }
+
+        // For the compares, make the elements at DI continue the loop and one of them (the first, the
+        // last, a random one or none) end it. REPZ continues on equal elements, REPNZ on different ones.
+        if (kind >= 2 && cx)
+        {
+            const uint32_t elements = cx < 0x1000 ? cx : 0x1000;
+            uint32_t stop;
+            switch (Random(4))
+            {
+            case 0: stop = 0; break;
+            case 1: stop = cx - 1u; break;
+            case 2: stop = Random(cx); break;
+            default: stop = ~0u; break;
+            }
+
+            // Element e at DI equals, or differs in its top bit from, element e at SI (CMPS) or AL/AX (SCAS)
+            auto setElement = [&](uint32_t e, bool equal)
+            {
+                const uint16_t offset = (uint16_t)(backward ? -(int32_t)(e * size) : (int32_t)(e * size));
+                for (uint32_t b = 0; b < size; b++)
+                {
+                    const uint8_t source = kind == 3 ? (uint8_t)(ax >> (8 * b)) : data[(uint16_t)(si + offset + b)];
+                    data[(uint16_t)(di + offset + b)] = equal || b + 1 < size ? source : (uint8_t)(source ^ 0x80);
+                }
+            };
+            for (uint32_t e = 0; e < elements; e++)
+                setElement(e, prefix == 0xF3);
+            if (stop < cx)
+                setElement(stop, prefix != 0xF3);
+        }
+
+        const uint8_t program[] = {
+            0xBE, (uint8_t)si, (uint8_t)(si >> 8), // mov si, si
+            0xBF, (uint8_t)di, (uint8_t)(di >> 8), // mov di, di
+            0xB9, (uint8_t)cx, (uint8_t)(cx >> 8), // mov cx, cx
+            prefix, opcode,
+        };
+        memcpy(code, program, sizeof(program));
+        memcpy(code + sizeof(program), next, sizeof(next));
+
+        state.regs16[RegES] = DataSegment;
+        state.regs16[RegAX] = ax;
+        for (int f = 0; f < 9; f++)
+        {
+            // No trap or interrupt flag, they would fire the emulator's interrupt stubs
+            state.regs8[FlagCF + f] = (f == 5 || f == 6) ? 0 : (uint8_t)Random(2);
+        }
+        state.regs8[FlagDF] = backward;
+
+        printf("%d", n);
+        for (uint8_t byte : program)
+            printf(" %02x", byte);
+        printf(" ax=%04x df=%d in=%08x", ax, (int)backward, Checksum(data));
+
+        uint16_t sp = 0xFFF0;
+        Run8086(CodeSegment, 0, DataSegment, StackSegment, &sp);
+
+        printf(" out cx=%04x si=%04x di=%04x ax=%04x ", state.regs16[RegCX], regsi, state.regs16[RegDI], state.regs16[RegAX]);
+        for (int f = 0; f < 9; f++)
+            putchar(state.regs8[FlagCF + f] ? s_flagNames[f] : '-');
+        printf(" mem=%08x\n", Checksum(data));
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+// rotoscope - the packed rotoscope planes against the Rotoscope they replaced
+//
+// Build:  see Plugins/StarflightRuntime/CMakeLists.txt
+// Usage:  rotoscope [cases]
+//
+// graphics.cpp used to keep a whole Rotoscope per pixel; it now splits it into
+// planes (content, colors, position, meta index). Every case draws random
+// Rotoscopes through GraphicsPixel, GraphicsFillSpan and GraphicsCopyRect, and
+// reads them back through GraphicsPeek, which must return every field the old
+// layout kept. Blit positions cover the whole int16_t range, negative origins
+// included, and colors the whole byte.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+
+#include "context.h"
+#include "graphics.h"
+
+static constexpr int Width = 160;
+static constexpr int Height = 200;
+static constexpr uint32_t Page = 0xA000;
+
+static std::mt19937 s_rng;
+
+static uint32_t Random(uint32_t n)
+{
+    return s_rng() % n;
+}
+
+static Rotoscope RandomRotoscope()
+{
+    static const PixelContents contents[] = { ClearPixel, NavigationalPixel, TextPixel, LinePixel, EllipsePixel, BoxFillPixel, PicPixel, RunBitPixel };
+    Rotoscope rs(contents[Random(sizeof(contents) / sizeof(contents[0]))]);
+    rs.fgColor = (uint8_t)s_rng();
+    rs.bgColor = (uint8_t)s_rng();
+    rs.blt_w = (int16_t)s_rng();
+    rs.blt_h = (int16_t)s_rng();
+    rs.lineData = { (int)s_rng(), (int)s_rng(), (int)s_rng(), (int)s_rng(), (int)s_rng(), 0 };
+    rs.textData.character = (char)s_rng();
+    rs.textData.fontNum = (uint16_t)s_rng();
+    rs.textData.xormode = (uint8_t)Random(2);
+    rs.runBitData.tag = s_rng();
+    rs.picData.picID = s_rng();
+
+    // Lines keep their step in the position plane, everything else its blit position
+    if (rs.content == LinePixel)
+    {
+        rs.lineData.n = (int)s_rng();
+    }
+    else
+    {
+        rs.blt_x = (int16_t)s_rng();
+        rs.blt_y = (int16_t)s_rng();
+    }
+    return rs;
+}
+
+// Returns the first field of the pixel at (x, y) that differs from expected, or nullptr
+static const char* Compare(int x, int y, int color, const Rotoscope& expected)
+{
+    Rotoscope rs;
+    if (GraphicsPeek(x, y, Page, &rs) != (color & 0xF)) return "color";
+    if (rs.content != expected.content) return "content";
+    if (rs.fgColor != expected.fgColor) return "fgColor";
+    if (rs.bgColor != expected.bgColor) return "bgColor";
+    if (rs.blt_x != expected.blt_x) return "blt_x";
+    if (rs.blt_y != expected.blt_y) return "blt_y";
+    if (rs.blt_w != expected.blt_w) return "blt_w";
+    if (rs.blt_h != expected.blt_h) return "blt_h";
+    if (rs.lineData.x0 != expected.lineData.x0 || rs.lineData.x1 != expected.lineData.x1 || rs.lineData.y0 != expected.lineData.y0 ||
+        rs.lineData.y1 != expected.lineData.y1 || rs.lineData.total != expected.lineData.total) return "lineData";
+    if (rs.lineData.n != expected.lineData.n) return "lineData.n";
+    if (rs.textData.character != expected.textData.character) return "character";
+    if (rs.textData.fontNum != expected.textData.fontNum) return "fontNum";
+    if (rs.textData.xormode != expected.textData.xormode) return "xormode";
+    if (rs.runBitData.tag != expected.runBitData.tag) return "runBitData.tag";
+    if (rs.picData.picID != expected.picData.picID) return "picID";
+    return nullptr;
+}
+
+int main(int argc, char** argv)
+{
+    const int cases = argc > 1 ? atoi(argv[1]) : 20000;
+
+    EmulatorContext::Current();
+    GraphicsInit();
+
+    for (int n = 0; n < cases; ++n)
+    {
+        s_rng.seed(n);
+        const int x = Random(Width);
+        const int y = Random(Height);
+        const int color = Random(16);
+        Rotoscope rs = RandomRotoscope();
+
+        const char* field = nullptr;
+        const char* path = nullptr;
+        switch (Random(3))
+        {
+        case 0:
+            path = "GraphicsPixel";
+            GraphicsPixel(x, y, color, Page, rs);
+            field = Compare(x, y, color, rs);
+            break;
+        case 1:
+            path = "GraphicsFillSpan";
+            GraphicsFillSpan(y, x, x, color, Page, rs);
+            field = Compare(x, y, color, rs);
+            break;
+        default:
+        {
+            // The copy keeps the source's colors and primitive data and takes content, position and size from pc
+            path = "GraphicsCopyRect";
+            const int dstX = Random(Width);
+            const int dstY = Random(Height);
+            GraphicsPixel(x, y, color, Page, rs);
+            Rotoscope pc = RandomRotoscope();
+            pc.content = rs.content == LinePixel ? NavigationalPixel : rs.content;
+            GraphicsCopyRect(x, y, 1, 1, dstX, dstY, Page, Page, &pc);
+
+            Rotoscope expected = rs;
+            expected.content = pc.content;
+            expected.blt_x = pc.blt_x;
+            expected.blt_y = pc.blt_y;
+            expected.blt_w = pc.blt_w;
+            expected.blt_h = pc.blt_h;
+            expected.lineData.n = 0;
+            field = Compare(dstX, dstY, color, expected);
+            break;
+        }
+        }
+
+        if (field)
+        {
+            fprintf(stderr, "case %d: %s at (%d, %d) content %d loses %s\n", n, path, x, y, (int)rs.content, field);
+            return 1;
+        }
+    }
+
+    printf("%d cases identical\n", cases);
+    return 0;
+}
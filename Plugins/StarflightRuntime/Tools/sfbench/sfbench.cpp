@@ -0,0 +1,433 @@
+// sfbench - runs scripted scenarios against the emulator core and prints JSON
+//
+// Build:  see Plugins/StarflightRuntime/CMakeLists.txt
+// Usage:  sfbench [-r root] [-o out.json] [-k] scenario.sfscript...
+//
+//   -r root   directory that contains starflt1-in/ (default: current directory)
+//   -o file   write the report to file instead of stdout
+//   -k        also time the presenter's index -> BGRA conversion, scalar against
+//             AVX2; with -k the scenarios are optional
+//
+// Every scenario boots the game in its own process, so they do not share
+// emulator state. Scenario scripts are plain text, one directive per line:
+//
+//   name <name>             name in the report (default: file name)
+//   steps <n>               stop after n Forth steps (default: 50000000)
+//   until <state>           stop once the high-level state is reached, e.g. Station
+//   clock <n>               virtual clock rate in words per millisecond (default: 100)
+//   at <words> key <code>   push a key once <words> words have executed
+//   at <words> text "<s>"   push the characters of s
+//   unrecorded              the key lines are still missing: reported, not run
+//
+// Key lines can be recorded from a UE session by starting it with
+// STARFLIGHT_RECORD_KEYS=<file>. Scenarios past the starport (launch, landing,
+// hyperspace, combat) need such a recording; until it is appended they are
+// marked unrecorded.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "HeadlessCore.h"
+#include "StarflightAssets.h"
+#include "StarflightBridge.h"
+#include "call.h"
+#include "cpu/cpu.h"
+#include "graphics.h"
+#include "pixelconvert.h"
+
+extern std::string g_ProjectDirectory;
+
+static const char* s_stateNames[] =
+{
+    "Off", "Unknown", "LOGO1", "LOGO2", "Station", "Starmap", "Comms", "Encounter", "InFlux",
+    "IntrastellarNavigation", "InterstellarNavigation", "Orbiting", "OrbitLanding",
+    "OrbitLanded", "OrbitTakeoff", "GameOps",
+};
+static const int s_stateCount = sizeof(s_stateNames) / sizeof(s_stateNames[0]);
+
+static int StateFromName(const char* name)
+{
+    for (int i = 0; i < s_stateCount; i++)
+    {
+        if (strcmp(s_stateNames[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+// ------------------------------------------------
+// Scenario scripts
+// ------------------------------------------------
+
+struct KeyEvent
+{
+    uint64_t words;
+    uint16_t key;
+};
+
+struct Scenario
+{
+    std::string name;
+    uint64_t maxSteps = 50000000;
+    int until = -1;
+    uint32_t wordsPerMs = 100;
+    std::vector<KeyEvent> keys;
+    bool recorded = true;
+};
+
+static bool LoadScenario(const char* path, Scenario& scenario)
+{
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return false;
+    }
+
+    const char* base = strrchr(path, '/');
+    scenario.name = base ? base + 1 : path;
+    scenario.name = scenario.name.substr(0, scenario.name.find('.'));
+
+    char line[512];
+    int lineno = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), fp))
+    {
+        lineno++;
+        bool quoted = false;
+        for (char* c = line; *c; c++)
+        {
+            if (*c == '"') quoted = !quoted;
+            if (*c == '#' && !quoted) { *c = 0; break; }
+        }
+
+        char word[64] = "", arg[256] = "";
+        unsigned long long words = 0;
+        if (sscanf(line, "%63s", word) != 1) continue;
+
+        if (strcmp(word, "name") == 0 && sscanf(line, "%*s %255s", arg) == 1)
+            scenario.name = arg;
+        else if (strcmp(word, "steps") == 0 && sscanf(line, "%*s %llu", &words) == 1)
+            scenario.maxSteps = words;
+        else if (strcmp(word, "clock") == 0 && sscanf(line, "%*s %llu", &words) == 1)
+            scenario.wordsPerMs = (uint32_t)words;
+        else if (strcmp(word, "until") == 0 && sscanf(line, "%*s %255s", arg) == 1 && StateFromName(arg) >= 0)
+            scenario.until = StateFromName(arg);
+        else if (strcmp(word, "unrecorded") == 0)
+            scenario.recorded = false;
+        else if (strcmp(word, "at") == 0 && sscanf(line, "%*s %llu %63s", &words, word) == 2)
+        {
+            if (strcmp(word, "key") == 0 && sscanf(line, "%*s %*s %*s %255s", arg) == 1)
+            {
+                scenario.keys.push_back({ words, (uint16_t)strtoul(arg, nullptr, 0) });
+            }
+            else if (strcmp(word, "text") == 0 && strchr(line, '"') && strrchr(line, '"') != strchr(line, '"'))
+            {
+                for (const char* c = strchr(line, '"') + 1; c != strrchr(line, '"'); c++)
+                    scenario.keys.push_back({ words, (uint16_t)(uint8_t)*c });
+            }
+            else ok = false;
+        }
+        else ok = false;
+
+        if (!ok) fprintf(stderr, "%s:%d: cannot parse '%s'\n", path, lineno, line);
+    }
+    fclose(fp);
+    return ok;
+}
+
+// ------------------------------------------------
+// Step time histogram
+//
+// Log-linear buckets: 16 per power of two, so percentiles are within ~6%.
+// ------------------------------------------------
+
+struct Histogram
+{
+    uint64_t buckets[64 * 16] = {};
+    uint64_t count = 0;
+    uint64_t max = 0;
+
+    static int Bucket(uint64_t ns)
+    {
+        if (ns < 16) return (int)ns;
+        int log2 = 63 - __builtin_clzll(ns);
+        return (log2 - 3) * 16 + (int)((ns >> (log2 - 4)) & 15);
+    }
+
+    static uint64_t BucketValue(int bucket)
+    {
+        if (bucket < 16) return bucket;
+        int log2 = bucket / 16 + 3;
+        return (uint64_t)(16 + bucket % 16) << (log2 - 4);
+    }
+
+    void Add(uint64_t ns)
+    {
+        buckets[Bucket(ns)]++;
+        count++;
+        if (ns > max) max = ns;
+    }
+
+    uint64_t Percentile(double p) const
+    {
+        uint64_t target = (uint64_t)(p * count);
+        uint64_t seen = 0;
+        for (int i = 0; i < 64 * 16; i++)
+        {
+            seen += buckets[i];
+            if (seen > target) return BucketValue(i);
+        }
+        return max;
+    }
+};
+
+// ------------------------------------------------
+// Runner
+// ------------------------------------------------
+
+static std::string RunScenario(const Scenario& scenario)
+{
+    using clock = std::chrono::steady_clock;
+
+    // Frame latency runs from GraphicsPublishFrame() to the frame sink, where the
+    // UE listeners copy the frame; their texture upload follows on the next tick
+    static uint64_t s_frames = 0;
+    static Histogram s_latency;
+    static int s_state = 0;
+    SetFrameSink([](const uint8_t*, int, int, int, const FStarflightDirtyRect*, int)
+    {
+        const uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+        s_latency.Add(now - GetFramePublishTime());
+        s_frames++;
+    });
+    SetStatusSink([](const FStarflightStatus& status) { s_state = (int)status.State; });
+
+    SetVirtualClock(scenario.wordsPerMs);
+    FStarflightAssets::Get().Initialize();
+    InitCPU();
+    GraphicsInit();
+    InitEmulator("");
+
+    static Histogram s_steps;
+    uint64_t presentNs = 0;
+    uint64_t frameIndex = 0;
+    uint64_t clockStart = GetClockMilliseconds();
+    size_t nextKey = 0;
+    bool reached = false;
+
+    auto start = clock::now();
+    enum RETURNCODE ret = OK;
+    uint64_t step = 0;
+    while (step < scenario.maxSteps && (ret == OK || ret == EXIT))
+    {
+        while (nextKey < scenario.keys.size() && GetWordsExecuted() >= scenario.keys[nextKey].words)
+            GraphicsPushKey(scenario.keys[nextKey++].key);
+
+        auto t0 = clock::now();
+        ret = Step();
+        auto t1 = clock::now();
+        s_steps.Add(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        step++;
+
+        // Present at 60 Hz of emulated time
+        if ((GetClockMilliseconds() - clockStart) * 60 >= frameIndex * 1000)
+        {
+            GraphicsUpdate();
+            presentNs += std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t1).count();
+            frameIndex++;
+        }
+
+        if (scenario.until >= 0 && s_state == scenario.until)
+        {
+            reached = true;
+            break;
+        }
+    }
+    double seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    uint64_t words = GetWordsExecuted();
+    uint64_t instructions = Get8086InstructionsExecuted();
+
+    char json[1024];
+    snprintf(json, sizeof(json),
+        "{\"name\":\"%s\",\"reached\":%s,\"final_state\":\"%s\",\"result\":%d,"
+        "\"steps\":%llu,\"words\":%llu,\"instructions\":%llu,\"frames\":%llu,\"keys\":%zu,"
+        "\"seconds\":%.6f,\"words_per_second\":%.0f,\"instructions_per_second\":%.0f,"
+        "\"step_ns\":{\"p50\":%llu,\"p99\":%llu,\"max\":%llu},"
+        "\"frame_latency_ns\":{\"p50\":%llu,\"p99\":%llu,\"max\":%llu},\"present_ms\":%.3f}",
+        scenario.name.c_str(), reached ? "true" : "false",
+        s_state < s_stateCount ? s_stateNames[s_state] : "Unknown", (int)ret,
+        (unsigned long long)step, (unsigned long long)words, (unsigned long long)instructions,
+        (unsigned long long)s_frames, nextKey,
+        seconds, seconds > 0 ? words / seconds : 0.0, seconds > 0 ? instructions / seconds : 0.0,
+        (unsigned long long)s_steps.Percentile(0.50), (unsigned long long)s_steps.Percentile(0.99),
+        (unsigned long long)s_steps.max,
+        (unsigned long long)s_latency.Percentile(0.50), (unsigned long long)s_latency.Percentile(0.99),
+        (unsigned long long)s_latency.max, presentNs / 1e6);
+
+    GraphicsQuit();
+    return json;
+}
+
+// Runs the scenario in a child process and returns its JSON line
+static std::string RunIsolated(const Scenario& scenario)
+{
+    if (!scenario.recorded)
+    {
+        char skipped[256];
+        snprintf(skipped, sizeof(skipped), "{\"name\":\"%s\",\"reached\":false,\"error\":\"unrecorded\"}", scenario.name.c_str());
+        return skipped;
+    }
+
+    int fds[2];
+    if (pipe(fds) != 0) return "";
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(fds[0]);
+        std::string json = RunScenario(scenario);
+        ssize_t written = write(fds[1], json.data(), json.size());
+        _exit(written == (ssize_t)json.size() ? 0 : 1);
+    }
+
+    close(fds[1]);
+    std::string json;
+    char buffer[1024];
+    ssize_t n;
+    while ((n = read(fds[0], buffer, sizeof(buffer))) > 0)
+        json.append(buffer, n);
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (json.empty())
+    {
+        char failed[256];
+        snprintf(failed, sizeof(failed), "{\"name\":\"%s\",\"reached\":false,\"error\":\"%s %d\"}",
+            scenario.name.c_str(), WIFSIGNALED(status) ? "signal" : "exit status",
+            WIFSIGNALED(status) ? WTERMSIG(status) : WEXITSTATUS(status));
+        json = failed;
+    }
+    return json;
+}
+
+// ------------------------------------------------
+// Conversion kernel
+// ------------------------------------------------
+
+typedef bool (*ConvertFn)(const uint8_t* index, int count, int scale, const uint32_t* palette, uint32_t* out);
+
+static bool ConvertScalar(const uint8_t* index, int count, int scale, const uint32_t* palette, uint32_t* out)
+{
+    ConvertIndexRowScalar(index, count, scale, palette, out);
+    return true;
+}
+
+// Converts a whole 160x200 graphics frame to 640x200 the way GraphicsUpdate()
+// does; returns ns per frame, or -1 when the kernel is not available
+static double TimeConvert(ConvertFn fn, const std::vector<uint8_t>& index, const uint32_t* palette, std::vector<uint32_t>& out)
+{
+    const int frames = 2000;
+    if (!fn(index.data(), 160, 4, palette, out.data())) return -1;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++)
+    {
+        for (int y = 0; y < 200; y++)
+        {
+            fn(index.data() + y * 160, 160, 4, palette, out.data() + y * 640);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / frames;
+}
+
+static std::string BenchConvert()
+{
+    std::vector<uint8_t> index(160 * 200);
+    for (size_t i = 0; i < index.size(); i++)
+    {
+        index[i] = (uint8_t)((i * 7 + i / 160) & 0xF);
+    }
+    uint32_t palette[16];
+    for (int i = 0; i < 16; i++)
+    {
+        palette[i] = 0xFF000000u | (uint32_t)(i * 0x0F0F0F);
+    }
+
+    std::vector<uint32_t> scalar(640 * 200), avx2(640 * 200);
+    double scalarNs = TimeConvert(ConvertScalar, index, palette, scalar);
+    double avx2Ns = TimeConvert(ConvertIndexRowAVX2, index, palette, avx2);
+    bool match = avx2Ns < 0 || scalar == avx2;
+
+    char json[256];
+    snprintf(json, sizeof(json),
+        "\"convert\":{\"scalar_ns_per_frame\":%.0f,\"avx2_ns_per_frame\":%.0f,\"match\":%s}",
+        scalarNs, avx2Ns, match ? "true" : "false");
+    return json;
+}
+
+static void Usage()
+{
+    fprintf(stderr, "usage: sfbench [-r root] [-o out.json] [-k] scenario.sfscript...\n");
+    exit(1);
+}
+
+int main(int argc, char** argv)
+{
+    std::string root = ".";
+    const char* output = nullptr;
+    std::vector<Scenario> scenarios;
+    bool kernels = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) root = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) output = argv[++i];
+        else if (strcmp(argv[i], "-k") == 0) kernels = true;
+        else if (argv[i][0] == '-') Usage();
+        else
+        {
+            Scenario scenario;
+            if (!LoadScenario(argv[i], scenario)) return 1;
+            scenarios.push_back(scenario);
+        }
+    }
+    if (scenarios.empty() && !kernels) Usage();
+
+    g_ProjectDirectory = root;
+    if (!g_ProjectDirectory.empty() && g_ProjectDirectory.back() != '/')
+        g_ProjectDirectory += '/';
+
+    FILE* out = output ? fopen(output, "w") : stdout;
+    if (out == NULL)
+    {
+        fprintf(stderr, "Cannot write %s\n", output);
+        return 1;
+    }
+
+    fprintf(out, "{");
+    if (kernels)
+    {
+        fprintf(out, "%s,\n", BenchConvert().c_str());
+    }
+    fprintf(out, "\"scenarios\":[\n");
+    for (size_t i = 0; i < scenarios.size(); i++)
+    {
+        std::string json = RunIsolated(scenarios[i]);
+        fprintf(out, "  %s%s\n", json.c_str(), i + 1 < scenarios.size() ? "," : "");
+        fflush(out);
+    }
+    fprintf(out, "]}\n");
+
+    if (out != stdout) fclose(out);
+    return 0;
+}
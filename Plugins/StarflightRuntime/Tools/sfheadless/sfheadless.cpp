@@ -0,0 +1,135 @@
+// sfheadless - boots Starflight without Unreal and runs a number of Forth steps
+//
+// Build:  see Plugins/StarflightRuntime/CMakeLists.txt
+// Usage:  sfheadless [-r root] [-n steps] [-f every] [-j instances] [-v]
+//
+//   -r root   directory that contains starflt1-in/ (default: current directory)
+//   -n steps  number of Forth steps to run (default: 1000000)
+//   -f every  call GraphicsUpdate() every this many steps, 0 = never (default: 0)
+//   -j n      run n independent instances, each on its own thread and EmulatorContext
+//   -v        forward the emulator log to stderr
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "HeadlessCore.h"
+#include "StarflightAssets.h"
+#include "call.h"
+#include "context.h"
+#include "cpu/cpu.h"
+#include "graphics.h"
+
+extern std::string g_ProjectDirectory;
+
+static void Usage()
+{
+    fprintf(stderr, "usage: sfheadless [-r root] [-n steps] [-f every] [-j instances] [-v]\n");
+    exit(1);
+}
+
+struct RunResult
+{
+    uint64_t steps = 0;
+    uint64_t words = 0;
+    enum RETURNCODE ret = OK;
+};
+
+// Boots and runs the context bound to the calling thread
+static RunResult Run(uint64_t steps, uint64_t updateEvery)
+{
+    InitCPU();
+    GraphicsInit();
+    InitEmulator("");
+
+    RunResult result;
+    while (result.steps < steps && (result.ret == OK || result.ret == EXIT))
+    {
+        result.ret = Step();
+        result.steps++;
+
+        if (updateEvery != 0 && result.steps % updateEvery == 0)
+            GraphicsUpdate();
+        if (IsGraphicsShutdown())
+            break;
+    }
+    result.words = GetWordsExecuted();
+
+    GraphicsQuit();
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    std::string root = ".";
+    uint64_t steps = 1000000;
+    uint64_t updateEvery = 0;
+    int instances = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) root = argv[++i];
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) steps = strtoull(argv[++i], nullptr, 0);
+        else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) updateEvery = strtoull(argv[++i], nullptr, 0);
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) instances = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-v") == 0) HeadlessSetLogVerbosity(ELogVerbosity::Log);
+        else Usage();
+    }
+
+    g_ProjectDirectory = root;
+    if (!g_ProjectDirectory.empty() && g_ProjectDirectory.back() != '/')
+        g_ProjectDirectory += '/';
+    if (instances < 1)
+        Usage();
+
+    FStarflightAssets::Get().Initialize();
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<RunResult> results(instances);
+    if (instances == 1)
+    {
+        results[0] = Run(steps, updateEvery);
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < instances; i++)
+        {
+            threads.emplace_back([&results, i, steps, updateEvery]()
+            {
+                auto context = std::make_unique<EmulatorContext>();
+                context->MakeCurrent();
+                results[i] = Run(steps, updateEvery);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    RunResult total;
+    for (const RunResult& result : results)
+    {
+        total.steps += result.steps;
+        total.words += result.words;
+        if (result.ret != OK && result.ret != EXIT)
+            total.ret = result.ret;
+    }
+
+    if (instances > 1)
+        printf("instances %d\n", instances);
+    printf("steps   %llu\n", (unsigned long long)total.steps);
+    printf("words   %llu\n", (unsigned long long)total.words);
+    printf("seconds %.3f\n", seconds);
+    printf("words/s %.0f\n", seconds > 0 ? total.words / seconds : 0.0);
+    printf("result  %d\n", (int)total.ret);
+
+    return (total.ret == OK || total.ret == EXIT) ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+// sftrace - prints a binary call trace written by EnableCallTrace()
+//
+// Build:  c++ -std=c++20 -I../../Source/StarflightRuntime/Emulator sftrace.cpp -o sftrace
+// Usage:  sftrace <trace.sfct> [thread]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+#include "calltrace.h"
+#include "dictionary.h"
+#include "directory.h"
+#include "overlays_data.h"
+
+// Same mapping as GetOverlayIndex() in findword.cpp
+static int OverlayIndex(uint16_t segment)
+{
+    static std::unordered_map<uint16_t, int> s_cache;
+
+    if (segment == 0)
+        return -1;
+
+    auto it = s_cache.find(segment);
+    if (it != s_cache.end())
+        return it->second;
+
+    int index = -1;
+    for (int i = 0; dir[i].name != NULL && index == -1; i++)
+    {
+        if (((uint32_t)segment << 4) != (uint32_t)dir[i].start)
+            continue;
+
+        for (int j = 0; overlays[j].name != NULL; j++)
+        {
+            if (overlays[j].id == dir[i].idx)
+            {
+                index = j;
+                break;
+            }
+        }
+    }
+
+    s_cache[segment] = index;
+    return index;
+}
+
+static const char* WordName(uint16_t word, int ovidx)
+{
+    for (int i = 0; dictionary[i].name != NULL; i++)
+    {
+        if (dictionary[i].word == word && (dictionary[i].ov == ovidx || dictionary[i].ov == -1))
+            return dictionary[i].name;
+    }
+    return "?";
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <trace.sfct> [thread]\n", argv[0]);
+        return 1;
+    }
+
+    int onlyThread = argc > 2 ? atoi(argv[2]) : -1;
+
+    FILE* fp = fopen(argv[1], "rb");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    CallTraceFileHeader header{};
+    if (fread(&header, sizeof(header), 1, fp) != 1 || header.magic != CallTraceMagic || header.version != CallTraceVersion)
+    {
+        fprintf(stderr, "%s is not a call trace\n", argv[1]);
+        fclose(fp);
+        return 1;
+    }
+
+    std::vector<uint8_t> encoded;
+    std::vector<CallTraceRecord> records;
+    CallTraceChunkHeader chunk{};
+
+    while (fread(&chunk, sizeof(chunk), 1, fp) == 1)
+    {
+        encoded.resize(chunk.encodedSize);
+        records.resize(chunk.recordCount);
+        if (fread(encoded.data(), 1, chunk.encodedSize, fp) != chunk.encodedSize ||
+            CallTraceDecode(encoded.data(), encoded.size(), records.data(), records.size()) != chunk.recordCount)
+        {
+            fprintf(stderr, "Truncated or corrupt chunk\n");
+            break;
+        }
+
+        if (onlyThread != -1 && (int)chunk.threadId != onlyThread)
+            continue;
+
+        if (chunk.droppedCount != 0)
+            printf("[thread %u] %u records dropped\n", chunk.threadId, chunk.droppedCount);
+
+        for (const CallTraceRecord& r : records)
+        {
+            int ovidx = OverlayIndex(r.ov);
+            const char* ovName = ovidx == -1 ? "STARFLT" : overlays[ovidx].name;
+            printf("%10u [%u] si=0x%04x ov=%-14s addr=0x%04x bx=0x%04x %s\n",
+                r.tick, chunk.threadId, r.si, ovName, r.addr, r.bx, WordName(r.bx + 2, ovidx));
+        }
+    }
+
+    fclose(fp);
+    return 0;
+}